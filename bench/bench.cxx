@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <args2/flags.hxx>
+#include <args2/parser.hxx>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <getopt.h>
+#include <sys/resource.h>
+
+namespace {
+/** What the replaced operator new has seen.  Sizes are kept in a header in
+ * front of every block, so live and peak are exact.
+ */
+struct Heap {
+  std::size_t allocations = 0;
+  std::size_t live = 0;
+  std::size_t peak = 0;
+};
+
+Heap heap;
+
+constexpr std::size_t header = alignof(std::max_align_t);
+} // namespace
+
+void *operator new(const std::size_t size) {
+  const auto block = static_cast<std::byte *>(std::malloc(size + header));
+  if (!block) {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<std::size_t *>(block) = size;
+  ++heap.allocations;
+  heap.live += size;
+  heap.peak = std::max(heap.peak, heap.live);
+  return block + header;
+}
+
+void operator delete(void *const pointer) noexcept {
+  if (pointer) {
+    const auto block = static_cast<std::byte *>(pointer) - header;
+    heap.live -= *reinterpret_cast<std::size_t *>(block);
+    std::free(block);
+  }
+}
+
+void operator delete(void *const pointer, std::size_t) noexcept {
+  operator delete(pointer);
+}
+
+namespace {
+/** Arguments to parse, and the flags that they use.  Everything is ASCII, so
+ * that it can be widened for the char32_t runs.
+ */
+struct Workload {
+  std::string name;
+  std::vector<std::string> args;
+  std::string short_flags;
+  std::string short_value_flags;
+  std::vector<std::string> long_flags;
+  std::vector<std::string> long_value_flags;
+};
+
+Workload short_clusters(std::mt19937 &random) {
+  Workload workload{"short clusters", {}, "abcdefgh", "op", {}, {}};
+  std::uniform_int_distribution<std::size_t> length(1, 6);
+  std::uniform_int_distribution<std::size_t> flag(0, 7);
+  std::uniform_int_distribution<int> value(0, 3);
+
+  workload.args.resize(1'000'000);
+  for (auto &arg : workload.args) {
+    arg = "-";
+    for (auto i = length(random); i > 0; --i) {
+      arg += workload.short_flags[flag(random)];
+    }
+    if (value(random) == 0) {
+      arg += "ofile";
+    }
+  }
+  return workload;
+}
+
+Workload long_values(std::mt19937 &random) {
+  Workload workload{"long flags with =",
+                    {},
+                    {},
+                    {},
+                    {},
+                    {"output", "input", "format", "level", "jobs", "target",
+                     "config", "prefix"}};
+  std::uniform_int_distribution<std::size_t> flag(
+      0, workload.long_value_flags.size() - 1);
+  std::uniform_int_distribution<int> number(0, 99999);
+
+  workload.args.resize(1'000'000);
+  for (auto &arg : workload.args) {
+    arg = "--" + workload.long_value_flags[flag(random)] + "=value" +
+          std::to_string(number(random));
+  }
+  return workload;
+}
+
+Workload positionals(std::mt19937 &random) {
+  Workload workload{"positionals", {}, "v", {}, {"verbose"}, {}};
+  std::uniform_int_distribution<int> number(0, 99999);
+
+  workload.args.resize(1'000'000);
+  for (auto &arg : workload.args) {
+    arg = "file" + std::to_string(number(random)) + ".txt";
+  }
+  return workload;
+}
+
+Workload large_flag_set(std::mt19937 &random) {
+  Workload workload{"800 long flags", {}, {}, {}, {}, {}};
+  std::uniform_int_distribution<int> letter('a', 'z');
+  std::uniform_int_distribution<std::size_t> length(4, 16);
+  const auto word = [&] {
+    std::string word(length(random), 'a');
+    std::ranges::generate(word,
+                          [&] { return static_cast<char>(letter(random)); });
+    return word;
+  };
+
+  for (std::size_t i = 0; i < 400; ++i) {
+    workload.long_flags.push_back(word() + "-" + std::to_string(i));
+    workload.long_value_flags.push_back(word() + "-" + std::to_string(i));
+  }
+  std::uniform_int_distribution<std::size_t> flag(0, 399);
+  std::uniform_int_distribution<int> value(0, 1);
+
+  // Fewer arguments, as getopt_long scans every flag for every argument.
+  workload.args.resize(200'000);
+  for (auto &arg : workload.args) {
+    if (value(random)) {
+      arg = "--" + workload.long_value_flags[flag(random)] + "=value";
+    } else {
+      arg = "--" + workload.long_flags[flag(random)];
+    }
+  }
+  return workload;
+}
+
+template <typename CharT>
+std::basic_string<CharT> widen(const std::string_view text) {
+  return std::basic_string<CharT>(text.begin(), text.end());
+}
+
+/** A workload's arguments and flags in one character type, with the flag
+ * lookups built ahead of time, as a program would.
+ */
+template <typename CharT> struct Prepared {
+  std::vector<std::basic_string<CharT>> args;
+  std::vector<std::basic_string<CharT>> long_flags;
+  std::vector<std::basic_string<CharT>> long_value_flags;
+  args2::parser::SetFlags<CharT> sets;
+  args2::parser::FlagTable<CharT> table;
+
+  explicit Prepared(const Workload &workload) {
+    for (const auto &arg : workload.args) {
+      args.push_back(widen<CharT>(arg));
+    }
+    for (const auto &flag : workload.long_flags) {
+      long_flags.push_back(widen<CharT>(flag));
+    }
+    for (const auto &flag : workload.long_value_flags) {
+      long_value_flags.push_back(widen<CharT>(flag));
+    }
+    const auto short_flags = widen<CharT>(workload.short_flags);
+    const auto short_value_flags = widen<CharT>(workload.short_value_flags);
+    const std::vector<std::basic_string_view<CharT>> long_views(
+        long_flags.begin(), long_flags.end());
+    const std::vector<std::basic_string_view<CharT>> long_value_views(
+        long_value_flags.begin(), long_value_flags.end());
+
+    sets = args2::parser::SetFlags<CharT>{
+        {short_flags.begin(), short_flags.end()},
+        {short_value_flags.begin(), short_value_flags.end()},
+        {long_views.begin(), long_views.end()},
+        {long_value_views.begin(), long_value_views.end()}};
+    table = args2::parser::FlagTable<CharT>(short_flags, short_value_flags,
+                                            long_views, long_value_views);
+  }
+};
+
+/** Count the results of a parse, failing loudly on errors, as the workloads
+ * are all valid.
+ */
+template <typename Parser> std::size_t consume(const Parser &parser) {
+  std::size_t results = 0;
+  for (const auto &result : parser) {
+    if (result.index() != 0) {
+      std::fputs("args2 reported an error on a valid workload\n", stderr);
+      std::exit(EXIT_FAILURE);
+    }
+    ++results;
+  }
+  return results;
+}
+
+/** Parses with the original hash sets, copying them into the parser every
+ * time, like building a new Parser does.
+ */
+template <typename CharT> std::size_t parse_sets(const Prepared<CharT> &in) {
+  using It = typename std::vector<std::basic_string<CharT>>::const_iterator;
+  const args2::parser::Parser<CharT, It> parser(in.args.begin(), in.args.end(),
+                                                in.sets);
+  return consume(parser);
+}
+
+/** Parses with a shared FlagTable, referred to by the parser.
+ */
+template <typename CharT> std::size_t parse_table(const Prepared<CharT> &in) {
+  return consume(args2::parser::Parser(in.args, in.table));
+}
+
+/** The same workload set up for getopt_long, which permutes nothing and
+ * returns positionals in order, thanks to the leading `-` of optstring.
+ */
+struct Getopt {
+  std::vector<char *> argv;
+  std::string optstring = "-";
+  std::vector<option> options;
+
+  explicit Getopt(Workload &workload) {
+    static char program[] = "bench";
+    argv.push_back(program);
+    for (auto &arg : workload.args) {
+      argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    optstring += workload.short_flags;
+    for (const char flag : workload.short_value_flags) {
+      optstring += flag;
+      optstring += ':';
+    }
+    for (const auto &flag : workload.long_flags) {
+      options.push_back(option{flag.c_str(), no_argument, nullptr, 0});
+    }
+    for (const auto &flag : workload.long_value_flags) {
+      options.push_back(option{flag.c_str(), required_argument, nullptr, 0});
+    }
+    options.push_back(option{nullptr, 0, nullptr, 0});
+  }
+};
+
+std::size_t parse_getopt(const Getopt &in) {
+  // Reinitializes getopt completely.
+  optind = 0;
+  opterr = 0;
+
+  std::size_t results = 0;
+  int index;
+  int found;
+  while ((found = getopt_long(static_cast<int>(in.argv.size() - 1),
+                              in.argv.data(), in.optstring.c_str(),
+                              in.options.data(), &index)) != -1) {
+    if (found == '?' || found == ':') {
+      std::fputs("getopt_long reported an error on a valid workload\n",
+                 stderr);
+      std::exit(EXIT_FAILURE);
+    }
+    ++results;
+  }
+  return results;
+}
+
+struct Measurement {
+  double ns_per_arg = std::numeric_limits<double>::infinity();
+  std::size_t allocations = 0;
+  std::size_t peak = 0;
+  std::size_t results = 0;
+};
+
+/** Run parse a few times, keeping the fastest run.  Allocations and peak heap
+ * growth are those of a single parse.
+ */
+Measurement measure(const std::size_t args,
+                    const std::function<std::size_t()> &parse) {
+  constexpr int runs = 5;
+
+  Measurement measurement;
+  for (int run = 0; run < runs; ++run) {
+    const auto allocations = heap.allocations;
+    const auto live = heap.live;
+    heap.peak = heap.live;
+
+    const auto start = std::chrono::steady_clock::now();
+    measurement.results = parse();
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    measurement.ns_per_arg =
+        std::min(measurement.ns_per_arg, elapsed.count() / args);
+    measurement.allocations = heap.allocations - allocations;
+    measurement.peak = std::max(measurement.peak, heap.peak - live);
+  }
+  return measurement;
+}
+
+void report(const std::string_view workload, const std::string_view parser,
+            const std::size_t args, const Measurement &measurement) {
+  std::printf("%-18.*s %-22.*s %9zu %9zu %9.2f %12zu %14zu\n",
+              static_cast<int>(workload.size()), workload.data(),
+              static_cast<int>(parser.size()), parser.data(), args,
+              measurement.results, measurement.ns_per_arg,
+              measurement.allocations, measurement.peak);
+}
+
+template <typename CharT>
+void run(const Workload &workload, const std::string_view type) {
+  const Prepared<CharT> prepared(workload);
+  const auto args = prepared.args.size();
+  const std::string sets = "args2 sets<" + std::string(type) + ">";
+  const std::string table = "args2 table<" + std::string(type) + ">";
+
+  report(workload.name, sets, args,
+         measure(args, [&] { return parse_sets(prepared); }));
+  report(workload.name, table, args,
+         measure(args, [&] { return parse_table(prepared); }));
+}
+} // namespace
+
+/** Benchmarks the parser against glibc's getopt_long on synthetic workloads.
+ * Build it optimized, with -DARGS2_BENCHMARKS=ON and a Release build type.
+ */
+int main() {
+  std::mt19937 random(20240601);
+  std::vector<Workload> workloads;
+  workloads.push_back(short_clusters(random));
+  workloads.push_back(long_values(random));
+  workloads.push_back(positionals(random));
+  workloads.push_back(large_flag_set(random));
+
+  std::printf("%-18s %-22s %9s %9s %9s %12s %14s\n", "workload", "parser",
+              "args", "results", "ns/arg", "allocs/parse", "peak heap (B)");
+  for (auto &workload : workloads) {
+    run<char>(workload, "char");
+    run<char32_t>(workload, "char32_t");
+
+    const Getopt prepared(workload);
+    report(
+        workload.name, "getopt_long", workload.args.size(),
+        measure(workload.args.size(), [&] { return parse_getopt(prepared); }));
+  }
+
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  std::printf("\npeak resident set size: %ld KiB\n", usage.ru_maxrss);
+  return 0;
+}
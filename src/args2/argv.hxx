@@ -1,3 +1,5 @@
+#pragma once
+
 #include <compare>
 #include <concepts>
 #include <cstdlib>
@@ -22,21 +24,18 @@ template <typename CharT> class Iterator {
 private:
   int argc;
   const CharT **argv;
-  std::basic_string_view<CharT> value;
 
 public:
-  Iterator(int argc, const CharT **argv) noexcept
-      : argc(argc), argv(argv), value(*argv) {}
+  Iterator(int argc, const CharT **argv) noexcept : argc(argc), argv(argv) {}
   Iterator() noexcept : argc(0), argv(nullptr) {}
 
-  const std::basic_string_view<CharT> &operator*() const noexcept {
-    return value;
-  }
+  // Returned by value, like operator[], so that this is a random access
+  // iterator.
+  std::basic_string_view<CharT> operator*() const noexcept { return *argv; }
 
   Iterator &operator++() noexcept {
     --argc;
     ++argv;
-    value = *argv;
     return *this;
   }
   Iterator operator++(int) noexcept {
@@ -47,7 +46,6 @@ public:
   Iterator &operator--() noexcept {
     ++argc;
     --argv;
-    value = *argv;
     return *this;
   }
   Iterator operator--(int) noexcept {
@@ -59,21 +57,21 @@ public:
   Iterator &operator+=(const int n) noexcept {
     argv += n;
     argc -= n;
-    value = *argv;
+    return *this;
   }
 
   Iterator operator+(const int n) const noexcept {
-    Iterator other;
+    Iterator other = *this;
     other += n;
     return other;
   }
   Iterator &operator-=(const int n) noexcept {
     argv -= n;
     argc += n;
-    value = *argv;
+    return *this;
   }
   Iterator operator-(const int n) const noexcept {
-    Iterator other;
+    Iterator other = *this;
     other -= n;
     return other;
   }
@@ -85,6 +83,9 @@ public:
   std::basic_string_view<CharT> operator[](const int n) const noexcept {
     return argv[n];
   }
+  bool operator==(const Iterator &other) const noexcept {
+    return argc == other.argc;
+  }
   std::strong_ordering operator<=>(const Iterator &other) const noexcept {
     // Order is reversed, because argc decrements.
     return other.argc <=> argc;
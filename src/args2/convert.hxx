@@ -0,0 +1,352 @@
+#pragma once
+
+#include <args2/parser.hxx>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace args2 {
+namespace convert {
+/** A size in bytes, written with an optional unit, like `512`, `4K`, `2GiB`,
+ * or `10MB`.  A bare unit letter (`K`, `M`, `G`, `T`, `P`, `E`, or `k`) or
+ * one followed by `iB` is a power of 1024, and one followed by `B` is a power
+ * of 1000.
+ */
+struct Size {
+  std::uint64_t bytes = 0;
+
+  auto operator<=>(const Size &) const noexcept = default;
+};
+
+/** Either a converted value, or why it couldn't be converted.
+ */
+template <typename T> using Parsed = std::variant<T, parser::InvalidValue>;
+
+namespace detail {
+// Wide values are narrowed into a buffer of this size for std::from_chars,
+// so longer ones are malformed.
+inline constexpr std::size_t narrow_capacity = 256;
+
+template <typename T> struct is_duration : std::false_type {};
+
+template <typename Rep, typename Period>
+struct is_duration<std::chrono::duration<Rep, Period>> : std::true_type {};
+
+template <typename CharT>
+constexpr bool is(const std::basic_string_view<CharT> text,
+                  const std::string_view ascii) noexcept {
+  if (text.size() != ascii.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    if (text[i] != static_cast<CharT>(ascii[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename CharT>
+constexpr std::size_t
+digits(const std::basic_string_view<CharT> text) noexcept {
+  std::size_t count = 0;
+  while (count < text.size() && text[count] >= CharT('0') &&
+         text[count] <= CharT('9')) {
+    ++count;
+  }
+  return count;
+}
+
+/** The longest duration that both T and std::chrono::nanoseconds can hold.
+ */
+template <typename T>
+constexpr std::chrono::nanoseconds max_nanoseconds() noexcept {
+  // Compared in floating point, as converting T::max() to nanoseconds may
+  // overflow.
+  using Limit = std::chrono::duration<long double, std::nano>;
+  if (Limit(T::max()) >= Limit(std::chrono::nanoseconds::max())) {
+    return std::chrono::nanoseconds::max();
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(T::max());
+}
+
+constexpr parser::InvalidValue invalid(const std::errc error) noexcept {
+  return error == std::errc::result_out_of_range
+             ? parser::InvalidValue::out_of_range
+             : parser::InvalidValue::malformed;
+}
+
+/** std::from_chars over the whole text.  Single-byte characters are read in
+ * place, wider ones are narrowed to ASCII on the stack first, and are
+ * malformed past narrow_capacity characters.
+ */
+template <typename T, typename CharT>
+Parsed<T> from_chars(const std::basic_string_view<CharT> text) noexcept {
+  if constexpr (sizeof(CharT) == 1) {
+    const auto begin = reinterpret_cast<const char *>(text.data());
+    const auto end = begin + text.size();
+    T value{};
+    const auto [position, error] = std::from_chars(begin, end, value);
+    if (error != std::errc()) {
+      return invalid(error);
+    } else if (position != end) {
+      return parser::InvalidValue::malformed;
+    }
+    return value;
+  } else {
+    if (text.size() > narrow_capacity) {
+      return parser::InvalidValue::malformed;
+    }
+    char buffer[narrow_capacity];
+    for (std::size_t i = 0; i < text.size(); ++i) {
+      if (static_cast<std::uint32_t>(text[i]) > 0x7f) {
+        return parser::InvalidValue::malformed;
+      }
+      buffer[i] = static_cast<char>(text[i]);
+    }
+    return from_chars<T>(std::string_view(buffer, text.size()));
+  }
+}
+
+template <typename CharT, typename Flag, typename T>
+std::variant<T, parser::Error<CharT>> wrap(const Flag &flag,
+                                           Parsed<T> parsed) noexcept {
+  if (const auto value = std::get_if<T>(&parsed)) {
+    return std::move(*value);
+  }
+  return parser::Error<CharT>(parser::InvalidValueError<CharT>{
+      flag, std::get<parser::InvalidValue>(parsed)});
+}
+} // namespace detail
+
+template <typename T>
+concept Number = (std::integral<T> && !std::same_as<T, bool>) ||
+                 std::floating_point<T>;
+
+template <typename T>
+concept Duration = detail::is_duration<T>::value;
+
+/** Parse a decimal integer or a floating point number, with the syntax of
+ * std::from_chars.  Values in characters wider than a byte are malformed if
+ * they are longer than 256 characters.
+ */
+template <Number T, typename CharT>
+Parsed<T> parse(const std::basic_string_view<CharT> text) noexcept {
+  return detail::from_chars<T>(text);
+}
+
+/** Parse a Size.
+ */
+template <std::same_as<Size> T, typename CharT>
+Parsed<T> parse(const std::basic_string_view<CharT> text) noexcept {
+  const auto split = detail::digits(text);
+  const auto number = detail::from_chars<std::uint64_t>(text.substr(0, split));
+  if (const auto error = std::get_if<parser::InvalidValue>(&number)) {
+    return *error;
+  }
+
+  const auto unit = text.substr(split);
+  std::uint64_t multiplier = 1;
+  if (!unit.empty() && !detail::is(unit, "B")) {
+    constexpr std::string_view prefixes = "KMGTPE";
+    auto power = prefixes.find(static_cast<char>(unit.front()));
+    if (unit.front() == CharT('k')) {
+      power = 0;
+    } else if (static_cast<std::uint32_t>(unit.front()) > 0x7f ||
+               power == prefixes.npos) {
+      return parser::InvalidValue::malformed;
+    }
+
+    const auto rest = unit.substr(1);
+    std::uint64_t base;
+    if (rest.empty() || detail::is(rest, "iB")) {
+      base = 1024;
+    } else if (detail::is(rest, "B")) {
+      base = 1000;
+    } else {
+      return parser::InvalidValue::malformed;
+    }
+    for (std::size_t i = 0; i <= power; ++i) {
+      multiplier *= base;
+    }
+  }
+
+  const auto bytes = std::get<std::uint64_t>(number);
+  if (bytes > std::numeric_limits<std::uint64_t>::max() / multiplier) {
+    return parser::InvalidValue::out_of_range;
+  }
+  return Size{bytes * multiplier};
+}
+
+/** Parse a duration as an integer followed by a unit: `ns`, `us`, `ms`, `s`,
+ * `m`, `h`, or `d`, like `250ms`.  The unit is required.  Durations are
+ * counted in nanoseconds before being cast to T, so they must be within about
+ * 292 years.  Durations that T can't hold exactly, because they are too long
+ * or finer than its period, are out of range.
+ */
+template <Duration T, typename CharT>
+Parsed<T> parse(const std::basic_string_view<CharT> text) noexcept {
+  const auto split = detail::digits(text);
+  const auto number = detail::from_chars<std::int64_t>(text.substr(0, split));
+  if (const auto error = std::get_if<parser::InvalidValue>(&number)) {
+    return *error;
+  }
+
+  constexpr std::pair<std::string_view, std::int64_t> units[] = {
+      {"ns", 1},
+      {"us", 1'000},
+      {"ms", 1'000'000},
+      {"s", 1'000'000'000},
+      {"m", 60'000'000'000},
+      {"h", 3'600'000'000'000},
+      {"d", 86'400'000'000'000},
+  };
+  const auto unit = text.substr(split);
+  for (const auto &[name, nanoseconds] : units) {
+    if (detail::is(unit, name)) {
+      const auto count = std::get<std::int64_t>(number);
+      if (count > std::numeric_limits<std::int64_t>::max() / nanoseconds) {
+        return parser::InvalidValue::out_of_range;
+      }
+      const std::chrono::nanoseconds exact(count * nanoseconds);
+      if (exact > detail::max_nanoseconds<T>()) {
+        return parser::InvalidValue::out_of_range;
+      }
+      const auto duration = std::chrono::duration_cast<T>(exact);
+      if constexpr (!std::chrono::treat_as_floating_point_v<
+                        typename T::rep>) {
+        if (std::chrono::duration_cast<std::chrono::nanoseconds>(duration) !=
+            exact) {
+          return parser::InvalidValue::out_of_range;
+        }
+      }
+      return duration;
+    }
+  }
+  return parser::InvalidValue::malformed;
+}
+
+/** Parse one of a fixed set of names, like an enum, by looking it up in
+ * names, a range of name and value pairs.
+ */
+template <typename T, typename CharT, std::ranges::input_range Names>
+  requires std::convertible_to<
+      std::ranges::range_reference_t<const Names>,
+      const std::pair<std::basic_string_view<CharT>, T> &>
+Parsed<T> parse(const std::basic_string_view<CharT> text,
+                const Names &names) noexcept {
+  for (const std::pair<std::basic_string_view<CharT>, T> &name : names) {
+    if (name.first == text) {
+      return name.second;
+    }
+  }
+  return parser::InvalidValue::malformed;
+}
+
+/** Parse a comma-separated list into out, without allocating.  Returns the
+ * part of out that was filled in, or too_many if it didn't fit.  An empty
+ * text is an empty list.
+ *
+ * Lists of integers in single-byte characters take a fast path, which hands
+ * the whole text to std::from_chars one element at a time and only checks the
+ * separator where each number ends, instead of finding every separator first.
+ */
+template <typename T, typename CharT>
+std::variant<std::span<T>, parser::InvalidValue>
+parse_list(const std::basic_string_view<CharT> text,
+           const std::span<T> out) noexcept {
+  constexpr CharT separator(',');
+
+  if (text.empty()) {
+    return out.first(0);
+  }
+
+  std::size_t count = 0;
+  if constexpr (sizeof(CharT) == 1 && std::integral<T> &&
+                !std::same_as<T, bool>) {
+    auto position = reinterpret_cast<const char *>(text.data());
+    const auto end = position + text.size();
+    while (true) {
+      if (count == out.size()) {
+        return parser::InvalidValue::too_many;
+      }
+      const auto result = std::from_chars(position, end, out[count]);
+      if (result.ec != std::errc()) {
+        return detail::invalid(result.ec);
+      }
+      ++count;
+      if (result.ptr == end) {
+        break;
+      } else if (*result.ptr != static_cast<char>(separator)) {
+        return parser::InvalidValue::malformed;
+      }
+      position = result.ptr + 1;
+    }
+  } else {
+    auto rest = text;
+    while (true) {
+      if (count == out.size()) {
+        return parser::InvalidValue::too_many;
+      }
+      const auto split = rest.find(separator);
+      auto element = parse<T>(rest.substr(0, split));
+      if (const auto error = std::get_if<parser::InvalidValue>(&element)) {
+        return *error;
+      }
+      out[count++] = std::move(std::get<T>(element));
+      if (split == rest.npos) {
+        break;
+      }
+      rest = rest.substr(split + 1);
+    }
+  }
+  return out.first(count);
+}
+
+/** Convert the value of a short value flag.  Any extra arguments are passed
+ * on to parse.  Failures come back as an InvalidValueError for the flag.
+ */
+template <typename T, typename CharT, typename... Args>
+std::variant<T, parser::Error<CharT>>
+value(const parser::ShortValueFlag<CharT> &flag, const Args &...args) noexcept {
+  return detail::wrap<CharT>(flag, parse<T>(flag.value, args...));
+}
+
+/** Convert the value of a long value flag.  Any extra arguments are passed
+ * on to parse.  Failures come back as an InvalidValueError for the flag.
+ */
+template <typename T, typename CharT, typename... Args>
+std::variant<T, parser::Error<CharT>>
+value(const parser::LongValueFlag<CharT> &flag, const Args &...args) noexcept {
+  return detail::wrap<CharT>(flag, parse<T>(flag.value, args...));
+}
+
+/** Convert the comma-separated list value of a short value flag into out.
+ */
+template <typename T, typename CharT>
+std::variant<std::span<T>, parser::Error<CharT>>
+list(const parser::ShortValueFlag<CharT> &flag,
+     const std::span<T> out) noexcept {
+  return detail::wrap<CharT>(flag, parse_list(flag.value, out));
+}
+
+/** Convert the comma-separated list value of a long value flag into out.
+ */
+template <typename T, typename CharT>
+std::variant<std::span<T>, parser::Error<CharT>>
+list(const parser::LongValueFlag<CharT> &flag,
+     const std::span<T> out) noexcept {
+  return detail::wrap<CharT>(flag, parse_list(flag.value, out));
+}
+} // namespace convert
+} // namespace args2
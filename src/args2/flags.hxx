@@ -0,0 +1,774 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace args2 {
+namespace parser {
+/** What a flag lookup knows about a single flag.
+ */
+enum class FlagKind : unsigned char {
+  // Not a flag that the parser knows about.
+  unknown,
+
+  // A flag that does not take a value.
+  flag,
+
+  // A flag that takes a value.
+  value_flag,
+};
+
+/** What a long flag lookup found, allowing for abbreviations.
+ */
+template <typename CharT> struct LongMatch {
+  FlagKind kind = FlagKind::unknown;
+
+  // The full name of the flag.  This is the looked up view itself, unless it
+  // was an abbreviation.
+  std::basic_string_view<CharT> flag;
+
+  // If the flag is an abbreviation of more than one flag, all of them, in
+  // sorted order.  The kind is then unknown.
+  std::span<const std::basic_string_view<CharT>> candidates;
+};
+
+/** Anything that can classify short and long flags can drive the parser.
+ * Lookups must not throw, because they sit on the parser's noexcept hot path.
+ */
+template <typename Flags, typename CharT>
+concept FlagLookup = requires(const Flags &flags, const CharT short_flag,
+                              const std::basic_string_view<CharT> long_flag) {
+  { flags.short_kind(short_flag) } noexcept -> std::same_as<FlagKind>;
+  { flags.long_kind(long_flag) } noexcept -> std::same_as<FlagKind>;
+};
+
+/** A flag lookup that can also match long flags by abbreviation.  The parser
+ * uses long_match instead of long_kind when it is there.
+ */
+template <typename Flags, typename CharT>
+concept LongFlagMatch =
+    requires(const Flags &flags, const std::basic_string_view<CharT> flag) {
+      { flags.long_match(flag) } noexcept -> std::same_as<LongMatch<CharT>>;
+    };
+
+/** How a FlagTable matches long flags.
+ */
+enum class LongMatching : unsigned char {
+  // Only flags that are spelled out in full.
+  exact,
+
+  // Also unambiguous prefixes of flags, like getopt_long, so that `--verb`
+  // is `--verbose` if no other flag starts with `verb`.
+  abbreviations,
+};
+
+/** The original runtime flag lookup, owning four hash sets.
+ */
+template <typename CharT> struct SetFlags {
+  std::unordered_set<CharT> short_flags;
+  std::unordered_set<CharT> short_value_flags;
+  std::unordered_set<std::basic_string_view<CharT>> long_flags;
+  std::unordered_set<std::basic_string_view<CharT>> long_value_flags;
+
+  FlagKind short_kind(const CharT flag) const noexcept {
+    if (short_flags.count(flag)) {
+      return FlagKind::flag;
+    } else if (short_value_flags.count(flag)) {
+      return FlagKind::value_flag;
+    } else {
+      return FlagKind::unknown;
+    }
+  }
+
+  FlagKind long_kind(const std::basic_string_view<CharT> flag) const noexcept {
+    if (long_flags.count(flag)) {
+      return FlagKind::flag;
+    } else if (long_value_flags.count(flag)) {
+      return FlagKind::value_flag;
+    } else {
+      return FlagKind::unknown;
+    }
+  }
+};
+
+namespace detail {
+/** Match a long flag with long_match if the lookup has it, or exactly with
+ * long_kind if it doesn't.
+ */
+template <typename CharT, typename Flags>
+constexpr LongMatch<CharT>
+long_match(const Flags &flags,
+           const std::basic_string_view<CharT> flag) noexcept {
+  if constexpr (LongFlagMatch<Flags, CharT>) {
+    return flags.long_match(flag);
+  } else {
+    return LongMatch<CharT>{flags.long_kind(flag), flag, {}};
+  }
+}
+
+/** Seeded FNV-1a with a murmur finalizer, so that every seed gives a
+ * well-mixed, independent hash.
+ */
+template <typename CharT>
+constexpr std::uint64_t
+hash(const std::uint64_t seed,
+     const std::basic_string_view<CharT> value) noexcept {
+  std::uint64_t hash = 0xcbf29ce484222325ull ^ (seed * 0x9e3779b97f4a7c15ull);
+  for (const auto c : value) {
+    hash ^= static_cast<std::uint64_t>(c);
+    hash *= 0x100000001b3ull;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+template <typename CharT>
+constexpr std::uint64_t hash(const std::uint64_t seed,
+                             const CharT value) noexcept {
+  return hash(seed, std::basic_string_view<CharT>(&value, 1));
+}
+
+/** A direct classification table for single-byte characters.  One load, no
+ * hashing.
+ */
+template <typename CharT> class ByteTable {
+  static_assert(sizeof(CharT) == 1);
+
+private:
+  std::array<FlagKind, 256> kinds{};
+
+public:
+  constexpr ByteTable() noexcept = default;
+
+  constexpr void insert(const CharT flag, const FlagKind kind) noexcept {
+    kinds[static_cast<unsigned char>(flag)] = kind;
+  }
+
+  constexpr FlagKind find(const CharT flag) const noexcept {
+    return kinds[static_cast<unsigned char>(flag)];
+  }
+};
+
+/** A compile-time perfect hash table, built with hash-and-displace.
+ * Keys are split into buckets by one hash, and each bucket gets its own seed
+ * for a second hash that puts all of its keys in free slots.  A lookup is two
+ * hashes and a single key comparison, with no probing.
+ */
+template <typename Key, std::size_t Capacity> class PerfectTable {
+private:
+  static constexpr std::size_t bucket_count = Capacity == 0 ? 1 : Capacity;
+  static constexpr std::size_t slot_count = std::bit_ceil(Capacity * 2 + 1);
+
+  struct Slot {
+    Key key{};
+    FlagKind kind = FlagKind::unknown;
+  };
+
+  std::array<std::uint32_t, bucket_count> seeds{};
+  std::array<Slot, slot_count> slots{};
+
+  static constexpr std::size_t bucket(const Key &key) noexcept {
+    return hash(0, key) % bucket_count;
+  }
+
+  static constexpr std::size_t slot(const std::uint32_t seed,
+                                    const Key &key) noexcept {
+    return hash(seed, key) & (slot_count - 1);
+  }
+
+public:
+  constexpr PerfectTable() noexcept = default;
+
+  /** Build the table.  Fails to be a constant expression if there are more
+   * keys than the capacity, or if a key is given twice.
+   */
+  constexpr PerfectTable(const std::initializer_list<Key> flags,
+                         const std::initializer_list<Key> value_flags) {
+    std::array<Slot, Capacity> entries{};
+    std::size_t count = 0;
+    for (const auto &[list, kind] :
+         {std::pair(flags, FlagKind::flag),
+          std::pair(value_flags, FlagKind::value_flag)}) {
+      for (const auto &key : list) {
+        if (count == Capacity) {
+          throw "more flags than the schema capacity";
+        }
+        entries[count++] = Slot{key, kind};
+      }
+    }
+
+    // Place the largest buckets first, while the table is still empty.
+    std::array<std::size_t, Capacity> order{};
+    for (std::size_t i = 0; i < count; ++i) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.begin() + count,
+              [&](const std::size_t a, const std::size_t b) {
+                return bucket(entries[a].key) < bucket(entries[b].key);
+              });
+    std::array<std::size_t, bucket_count + 1> bucket_starts{};
+    for (std::size_t i = 0; i < count; ++i) {
+      ++bucket_starts[bucket(entries[i].key) + 1];
+    }
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+      bucket_starts[i + 1] += bucket_starts[i];
+    }
+    std::array<std::size_t, bucket_count> buckets{};
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+      buckets[i] = i;
+    }
+    std::sort(buckets.begin(), buckets.end(),
+              [&](const std::size_t a, const std::size_t b) {
+                return bucket_starts[a + 1] - bucket_starts[a] >
+                       bucket_starts[b + 1] - bucket_starts[b];
+              });
+
+    std::array<bool, slot_count> used{};
+    for (const auto b : buckets) {
+      const auto begin = bucket_starts[b];
+      const auto end = bucket_starts[b + 1];
+      if (begin == end) {
+        break;
+      }
+      // Equal keys always share a bucket, so duplicates only need checking
+      // here.
+      for (auto i = begin; i < end; ++i) {
+        for (auto j = i + 1; j < end; ++j) {
+          if (entries[order[i]].key == entries[order[j]].key) {
+            throw "flag declared twice";
+          }
+        }
+      }
+      for (std::uint32_t seed = 1;; ++seed) {
+        if (seed == 0x100000) {
+          throw "could not build a perfect hash for the schema";
+        }
+        auto placed = begin;
+        for (; placed < end; ++placed) {
+          const auto s = slot(seed, entries[order[placed]].key);
+          if (used[s]) {
+            break;
+          }
+          used[s] = true;
+        }
+        if (placed != end) {
+          // Roll back this attempt and try the next seed.
+          for (auto i = begin; i < placed; ++i) {
+            used[slot(seed, entries[order[i]].key)] = false;
+          }
+        } else {
+          seeds[b] = seed;
+          for (auto i = begin; i < end; ++i) {
+            const auto &entry = entries[order[i]];
+            slots[slot(seed, entry.key)] = entry;
+          }
+          break;
+        }
+      }
+    }
+  }
+
+  constexpr FlagKind find(const Key &key) const noexcept {
+    const auto &candidate = slots[slot(seeds[bucket(key)], key)];
+    // Empty slots hold no key to compare against in a constant expression.
+    return candidate.kind != FlagKind::unknown && candidate.key == key
+               ? candidate.kind
+               : FlagKind::unknown;
+  }
+};
+} // namespace detail
+
+/** A flag set that is fixed at compile time.
+ * Short flags of single-byte character types are classified with a direct
+ * table, and everything else with a collision-free perfect hash, so that
+ * classifying a flag never probes, allocates, or chases a pointer.
+ * The capacities are upper bounds on the number of short and long flags.
+ *
+ * Declare it as a constexpr object and pass it to the parser through
+ * StaticSchema to have the lookups bound at compile time:
+ *
+ *     static constexpr Schema<char, 3, 2> schema(
+ *         {'a', 'b'}, {'c'}, {"alpha"}, {"beta"});
+ *     Parser<char, It, StaticSchema<schema>> parser(args);
+ */
+template <typename CharT, std::size_t ShortCapacity, std::size_t LongCapacity>
+class Schema {
+public:
+  using char_type = CharT;
+
+private:
+  using ShortTable =
+      std::conditional_t<sizeof(CharT) == 1, detail::ByteTable<CharT>,
+                         detail::PerfectTable<CharT, ShortCapacity>>;
+
+  ShortTable short_table;
+  detail::PerfectTable<std::basic_string_view<CharT>, LongCapacity> long_table;
+
+  static consteval ShortTable
+  make_short_table(const std::initializer_list<CharT> short_flags,
+                   const std::initializer_list<CharT> short_value_flags) {
+    if constexpr (sizeof(CharT) == 1) {
+      if (short_flags.size() + short_value_flags.size() > ShortCapacity) {
+        throw "more flags than the schema capacity";
+      }
+      ShortTable table;
+      for (const auto &[list, kind] :
+           {std::pair(short_flags, FlagKind::flag),
+            std::pair(short_value_flags, FlagKind::value_flag)}) {
+        for (const auto flag : list) {
+          if (table.find(flag) != FlagKind::unknown) {
+            throw "flag declared twice";
+          }
+          table.insert(flag, kind);
+        }
+      }
+      return table;
+    } else {
+      return ShortTable(short_flags, short_value_flags);
+    }
+  }
+
+public:
+  consteval Schema(
+      const std::initializer_list<CharT> short_flags,
+      const std::initializer_list<CharT> short_value_flags,
+      const std::initializer_list<std::basic_string_view<CharT>> long_flags,
+      const std::initializer_list<std::basic_string_view<CharT>>
+          long_value_flags)
+      : short_table(make_short_table(short_flags, short_value_flags)),
+        long_table(long_flags, long_value_flags) {}
+
+  constexpr FlagKind short_kind(const CharT flag) const noexcept {
+    return short_table.find(flag);
+  }
+
+  constexpr FlagKind
+  long_kind(const std::basic_string_view<CharT> flag) const noexcept {
+    return long_table.find(flag);
+  }
+};
+
+/** Binds a constexpr Schema as a template argument, so that a parser using it
+ * carries no flag state at all and every lookup goes straight to the
+ * compile-time tables.
+ */
+template <const auto &schema> struct StaticSchema {
+  using char_type = typename std::remove_cvref_t<decltype(schema)>::char_type;
+
+  static constexpr FlagKind short_kind(const char_type flag) noexcept {
+    return schema.short_kind(flag);
+  }
+
+  static constexpr FlagKind
+  long_kind(const std::basic_string_view<char_type> flag) noexcept {
+    return schema.long_kind(flag);
+  }
+};
+
+/** A flag set that is only known at runtime, laid out for fast lookups.
+ * Short flags are classified by a direct table indexed by the character, with
+ * a small sorted array for wide characters outside of ASCII.  Long flags live
+ * in one contiguous array sorted by name, and again in one bucketed by length
+ * and then by their first and last few characters, so that an exact lookup
+ * usually compares the name against a single flag.  When the flags are given
+ * as sized ranges, building the table allocates once per array rather than
+ * once per flag, and looking a flag up never allocates.
+ *
+ * With LongMatching::abbreviations, the table also builds a compressed trie
+ * over the sorted names, flattened into two arrays, so that long_match finds a
+ * flag or all flags starting with a prefix in time linear in its length, no
+ * matter how many flags there are.
+ *
+ * The long flag strings are not copied, so they must outlive the table.  The
+ * table is meant to be built once and handed to parsers by reference, through
+ * FlagsRef.
+ */
+template <typename CharT> class FlagTable {
+private:
+  struct ShortEntry {
+    CharT flag;
+    FlagKind kind;
+  };
+
+  static constexpr std::size_t direct_size = sizeof(CharT) == 1 ? 256 : 128;
+
+  std::array<FlagKind, direct_size> short_direct{};
+  std::vector<ShortEntry> short_wide;
+
+  // Kept as two parallel arrays, so the names are contiguous on their own.
+  std::vector<std::basic_string_view<CharT>> long_names;
+  std::vector<FlagKind> long_kinds;
+
+  // The same flags for exact lookups, sorted by length, bucket key, and name,
+  // with where each length starts.  The keys are kept on their own, so that
+  // narrowing a length down to one key doesn't touch the names.
+  std::vector<std::uint32_t> length_starts;
+  std::vector<std::uint64_t> exact_keys;
+  std::vector<std::basic_string_view<CharT>> exact_names;
+  std::vector<FlagKind> exact_kinds;
+
+  // A trie node covers the contiguous range of long_names sharing a prefix,
+  // which is the first depth characters of any of them.  Nodes are only made
+  // where names branch, and each node's edges are contiguous and sorted.
+  struct TrieNode {
+    std::uint32_t first;
+    std::uint32_t last;
+    std::uint32_t depth;
+    std::uint32_t edges_begin;
+    std::uint32_t edges_end;
+  };
+
+  struct TrieEdge {
+    CharT c;
+    std::uint32_t node;
+  };
+
+  // Empty unless matching abbreviations.  The root is the first node.
+  std::vector<TrieNode> trie;
+  std::vector<TrieEdge> trie_edges;
+
+  static constexpr std::size_t direct_index(const CharT flag) noexcept {
+    if constexpr (sizeof(CharT) == 1) {
+      return static_cast<unsigned char>(flag);
+    } else {
+      // Negative values wrap around, and so also land in the wide array.
+      return static_cast<std::size_t>(flag);
+    }
+  }
+
+  static constexpr bool trie_less(const CharT a, const CharT b) noexcept {
+    // The same order that the names are sorted in.
+    return std::char_traits<CharT>::lt(a, b);
+  }
+
+  /** The first and last few characters of name packed into an integer, so
+   * that names of the same length can mostly be told apart without reading
+   * them, even when they share a prefix like `no-`.
+   */
+  static constexpr std::uint64_t
+  bucket_key(const std::basic_string_view<CharT> name) noexcept {
+    using Unsigned = std::make_unsigned_t<CharT>;
+    constexpr std::size_t bits = 8 * sizeof(CharT);
+    constexpr std::size_t half = 32 / bits;
+    std::uint64_t key = 0;
+    if (name.size() < 2 * half) {
+      for (const auto c : name) {
+        key = key << bits | static_cast<Unsigned>(c);
+      }
+    } else {
+      for (std::size_t i = 0; i < half; ++i) {
+        key = key << bits | static_cast<Unsigned>(name[i]);
+      }
+      for (std::size_t i = name.size() - half; i < name.size(); ++i) {
+        key = key << bits | static_cast<Unsigned>(name[i]);
+      }
+    }
+    return key;
+  }
+
+  void build_exact() {
+    std::size_t longest = 0;
+    for (const auto name : long_names) {
+      longest = std::max(longest, name.size());
+    }
+    length_starts.assign(longest + 2, 0);
+    for (const auto name : long_names) {
+      ++length_starts[name.size() + 1];
+    }
+    for (std::size_t length = 1; length < length_starts.size(); ++length) {
+      length_starts[length] += length_starts[length - 1];
+    }
+
+    std::vector<std::uint32_t> order(long_names.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      order[i] = static_cast<std::uint32_t>(i);
+    }
+    std::ranges::sort(order, {}, [this](const std::uint32_t i) {
+      return std::tuple(long_names[i].size(), bucket_key(long_names[i]),
+                        long_names[i]);
+    });
+
+    exact_keys.reserve(order.size());
+    exact_names.reserve(order.size());
+    exact_kinds.reserve(order.size());
+    for (const auto i : order) {
+      exact_keys.push_back(bucket_key(long_names[i]));
+      exact_names.push_back(long_names[i]);
+      exact_kinds.push_back(long_kinds[i]);
+    }
+  }
+
+  void build_trie() {
+    const auto node = [this](const std::size_t first, const std::size_t last) {
+      const auto front = long_names[first];
+      const auto back = long_names[last - 1];
+      std::size_t depth = 0;
+      while (depth < front.size() && depth < back.size() &&
+             front[depth] == back[depth]) {
+        ++depth;
+      }
+      return TrieNode{static_cast<std::uint32_t>(first),
+                      static_cast<std::uint32_t>(last),
+                      static_cast<std::uint32_t>(depth), 0, 0};
+    };
+
+    // A compressed trie has fewer nodes than twice its leaves.
+    trie.reserve(2 * long_names.size());
+    trie_edges.reserve(2 * long_names.size());
+    trie.push_back(node(0, long_names.size()));
+    // Breadth first, so that the edges of each node are added together.
+    for (std::size_t current = 0; current < trie.size(); ++current) {
+      const auto last = trie[current].last;
+      const auto depth = trie[current].depth;
+      auto first = trie[current].first;
+      if (long_names[first].size() == depth) {
+        // The prefix is itself a flag.  Sorting put it first.
+        ++first;
+      }
+
+      trie[current].edges_begin = trie_edges.size();
+      while (first < last) {
+        const auto c = long_names[first][depth];
+        auto next = first + 1;
+        while (next < last && long_names[next][depth] == c) {
+          ++next;
+        }
+        trie_edges.push_back(
+            TrieEdge{c, static_cast<std::uint32_t>(trie.size())});
+        trie.push_back(node(first, next));
+        first = next;
+      }
+      trie[current].edges_end = trie_edges.size();
+    }
+  }
+
+  /** The range of long_names that start with prefix.
+   */
+  std::pair<std::size_t, std::size_t>
+  prefixed(const std::basic_string_view<CharT> prefix) const noexcept {
+    const TrieNode *node = &trie.front();
+    // Characters of prefix before this are already known to match.
+    std::size_t matched = 0;
+    while (true) {
+      const auto name = long_names[node->first];
+      const std::size_t end = std::min<std::size_t>(prefix.size(), node->depth);
+      if (prefix.substr(matched, end - matched) !=
+          name.substr(matched, end - matched)) {
+        return {0, 0};
+      } else if (prefix.size() <= node->depth) {
+        return {node->first, node->last};
+      }
+
+      const auto c = prefix[node->depth];
+      const auto edges = std::span(trie_edges).subspan(
+          node->edges_begin, node->edges_end - node->edges_begin);
+      const auto edge =
+          std::ranges::lower_bound(edges, c, trie_less, &TrieEdge::c);
+      if (edge == edges.end() || edge->c != c) {
+        return {0, 0};
+      }
+      matched = node->depth + 1;
+      node = &trie[edge->node];
+    }
+  }
+
+public:
+  FlagTable() noexcept = default;
+
+  /** Build the table.  If a flag is given both with and without a value, the
+   * one without a value wins, like with SetFlags.  Long flags are only matched
+   * by abbreviation when asked to.
+   */
+  template <std::ranges::input_range ShortFlags = std::initializer_list<CharT>,
+            std::ranges::input_range ShortValueFlags =
+                std::initializer_list<CharT>,
+            std::ranges::input_range LongFlags =
+                std::initializer_list<std::basic_string_view<CharT>>,
+            std::ranges::input_range LongValueFlags =
+                std::initializer_list<std::basic_string_view<CharT>>>
+  FlagTable(const ShortFlags &short_flags,
+            const ShortValueFlags &short_value_flags,
+            const LongFlags &long_flags,
+            const LongValueFlags &long_value_flags,
+            const LongMatching long_matching = LongMatching::exact) {
+    const auto size = []<typename Range>(const Range &range) -> std::size_t {
+      if constexpr (std::ranges::sized_range<const Range>) {
+        return std::ranges::size(range);
+      } else {
+        return 0;
+      }
+    };
+    if constexpr (sizeof(CharT) > 1) {
+      short_wide.reserve(size(short_flags) + size(short_value_flags));
+    }
+
+    const auto add_short = [this](const CharT flag, const FlagKind kind) {
+      const auto index = direct_index(flag);
+      if (index < direct_size) {
+        if (short_direct[index] == FlagKind::unknown) {
+          short_direct[index] = kind;
+        }
+      } else {
+        short_wide.push_back(ShortEntry{flag, kind});
+      }
+    };
+    for (const CharT flag : short_flags) {
+      add_short(flag, FlagKind::flag);
+    }
+    for (const CharT flag : short_value_flags) {
+      add_short(flag, FlagKind::value_flag);
+    }
+    // Plain flags sort before value flags, so they win when deduplicating,
+    // and an unstable sort doesn't need a temporary buffer.
+    std::ranges::sort(short_wide, {}, [](const ShortEntry &entry) {
+      return std::pair(entry.flag, entry.kind);
+    });
+    const auto short_duplicates =
+        std::ranges::unique(short_wide, {}, &ShortEntry::flag);
+    short_wide.erase(short_duplicates.begin(), short_duplicates.end());
+
+    using Entry = std::pair<std::basic_string_view<CharT>, FlagKind>;
+    std::vector<Entry> entries;
+    entries.reserve(size(long_flags) + size(long_value_flags));
+    for (const std::basic_string_view<CharT> flag : long_flags) {
+      entries.emplace_back(flag, FlagKind::flag);
+    }
+    for (const std::basic_string_view<CharT> flag : long_value_flags) {
+      entries.emplace_back(flag, FlagKind::value_flag);
+    }
+    std::ranges::sort(entries);
+    const auto long_duplicates =
+        std::ranges::unique(entries, {}, &Entry::first);
+    entries.erase(long_duplicates.begin(), long_duplicates.end());
+
+    long_names.reserve(entries.size());
+    long_kinds.reserve(entries.size());
+    for (const auto &[flag, kind] : entries) {
+      long_names.push_back(flag);
+      long_kinds.push_back(kind);
+    }
+    build_exact();
+
+    if (long_matching == LongMatching::abbreviations && !long_names.empty()) {
+      build_trie();
+    }
+  }
+
+  FlagKind short_kind(const CharT flag) const noexcept {
+    const auto index = direct_index(flag);
+    if (index < direct_size) {
+      return short_direct[index];
+    }
+    const auto found =
+        std::ranges::lower_bound(short_wide, flag, {}, &ShortEntry::flag);
+    if (found != short_wide.end() && found->flag == flag) {
+      return found->kind;
+    } else {
+      return FlagKind::unknown;
+    }
+  }
+
+  FlagKind long_kind(const std::basic_string_view<CharT> flag) const noexcept {
+    if (flag.size() + 1 >= length_starts.size()) {
+      return FlagKind::unknown;
+    }
+    const std::size_t begin = length_starts[flag.size()];
+    const std::size_t end = length_starts[flag.size() + 1];
+    const auto keys = std::span(exact_keys).subspan(begin, end - begin);
+    const auto [first, last] = std::ranges::equal_range(keys, bucket_key(flag));
+    const std::size_t offset = begin + (first - keys.begin());
+    if (last - first == 1) {
+      return exact_names[offset] == flag ? exact_kinds[offset]
+                                         : FlagKind::unknown;
+    }
+    const auto names = std::span(exact_names).subspan(offset, last - first);
+    const auto found = std::ranges::lower_bound(names, flag);
+    if (found != names.end() && *found == flag) {
+      return exact_kinds[offset + (found - names.begin())];
+    } else {
+      return FlagKind::unknown;
+    }
+  }
+
+  /** Look up a long flag, also matching abbreviations if the table was built
+   * to.  A flag spelled out in full always wins over flags it is a prefix of.
+   */
+  LongMatch<CharT>
+  long_match(const std::basic_string_view<CharT> flag) const noexcept {
+    if (trie.empty()) {
+      return LongMatch<CharT>{long_kind(flag), flag, {}};
+    }
+
+    const auto [first, last] = prefixed(flag);
+    if (first == last) {
+      return LongMatch<CharT>{FlagKind::unknown, flag, {}};
+    } else if (long_names[first].size() == flag.size()) {
+      return LongMatch<CharT>{long_kinds[first], flag, {}};
+    } else if (last - first == 1) {
+      return LongMatch<CharT>{long_kinds[first], long_names[first], {}};
+    } else {
+      return LongMatch<CharT>{
+          FlagKind::unknown, flag,
+          std::span(long_names).subspan(first, last - first)};
+    }
+  }
+};
+
+/** Refers to a flag lookup that lives elsewhere, so that a parser can use a
+ * shared table without copying it.  The referenced lookup must outlive the
+ * parser and its iterators.
+ */
+template <typename Flags> class FlagsRef {
+private:
+  const Flags *flags = nullptr;
+
+public:
+  constexpr FlagsRef() noexcept = default;
+  constexpr FlagsRef(const Flags &flags) noexcept : flags(&flags) {}
+
+  constexpr FlagKind short_kind(const auto flag) const noexcept {
+    return flags->short_kind(flag);
+  }
+
+  constexpr FlagKind long_kind(const auto &flag) const noexcept {
+    return flags->long_kind(flag);
+  }
+
+  template <typename CharT>
+    requires LongFlagMatch<Flags, CharT>
+  constexpr LongMatch<CharT>
+  long_match(const std::basic_string_view<CharT> flag) const noexcept {
+    return flags->long_match(flag);
+  }
+};
+
+/** Whether a flag lookup is a cheap handle to tables that live outside of the
+ * parser.  Parser iterators copy these instead of pointing back into their
+ * parser.
+ */
+template <typename Flags> inline constexpr bool enable_borrowed_flags = false;
+
+template <typename Flags>
+inline constexpr bool enable_borrowed_flags<FlagsRef<Flags>> = true;
+
+template <const auto &schema>
+inline constexpr bool enable_borrowed_flags<StaticSchema<schema>> = true;
+} // namespace parser
+} // namespace args2
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <args2/flags.hxx>
+#include <args2/parser.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace args2 {
+namespace parallel {
+/** The shape of a single argument, independent of the ones around it.
+ */
+enum class Shape : unsigned char {
+  positional,
+  separator,
+  long_flag,
+  short_flags,
+};
+
+/** Everything that can be learned about an argument without looking at its
+ * neighbors.
+ */
+struct Classification {
+  static constexpr std::uint32_t no_value =
+      std::numeric_limits<std::uint32_t>::max();
+
+  Shape shape = Shape::positional;
+
+  // For long flags, the kind of the flag.  For short flags, the kind of the
+  // first flag in the block that isn't a plain flag, or flag if all are.
+  parser::FlagKind kind = parser::FlagKind::unknown;
+
+  // For long flags, whether the flag was not spelled out in full, so that the
+  // stitch has to look it up again for its full name or candidates.
+  bool abbreviated = false;
+
+  // For long flags, the position of the value separator in the block after
+  // the prefix, or no_value.  For short flags, the position of that first
+  // flag in the block.
+  std::uint32_t split = 0;
+};
+
+/** Classify one argument.  This is the part of parser::Iterator::next() that
+ * doesn't depend on earlier arguments.
+ */
+template <typename CharT, typename Flags>
+constexpr Classification classify(const std::basic_string_view<CharT> arg,
+                                  const Flags &flags) noexcept {
+  constexpr auto positional_separator =
+      parser::Separators<CharT>::positional_separator;
+  constexpr auto long_prefix = parser::Separators<CharT>::long_prefix;
+  constexpr auto short_prefix = parser::Separators<CharT>::short_prefix;
+  constexpr auto long_value_separator =
+      parser::Separators<CharT>::long_value_separator;
+
+  Classification classification;
+  if (arg == positional_separator) {
+    classification.shape = Shape::separator;
+  } else if (arg.size() > long_prefix.size() &&
+             arg.substr(0, long_prefix.size()) == long_prefix) {
+    const auto long_block = arg.substr(long_prefix.size());
+    const auto value_separator_position =
+        long_block.find(long_value_separator);
+    const auto flag = long_block.substr(0, value_separator_position);
+    const auto match = parser::detail::long_match(flags, flag);
+    classification.shape = Shape::long_flag;
+    classification.kind = match.kind;
+    classification.abbreviated =
+        match.flag.size() != flag.size() || !match.candidates.empty();
+    classification.split = value_separator_position == long_block.npos
+                               ? Classification::no_value
+                               : value_separator_position;
+  } else if (arg.size() > short_prefix.size() &&
+             arg.substr(0, short_prefix.size()) == short_prefix) {
+    const auto short_flags_block = arg.substr(short_prefix.size());
+    classification.shape = Shape::short_flags;
+    classification.kind = parser::FlagKind::flag;
+    classification.split = short_flags_block.size();
+    for (std::size_t i = 0; i < short_flags_block.size(); ++i) {
+      const auto kind = flags.short_kind(short_flags_block[i]);
+      if (kind != parser::FlagKind::flag) {
+        classification.kind = kind;
+        classification.split = i;
+        break;
+      }
+    }
+  }
+  return classification;
+}
+
+/** Parse a random access argument range across threads, writing the same
+ * Results, in the same order, as iterating the parser would.
+ *
+ * Every argument is first classified on its own, in chunks spread over up to
+ * threads threads.  A cheap sequential pass then stitches the classifications
+ * together, resolving separators, value flags that take the next argument,
+ * and errors.  Small inputs are parsed on the calling thread alone, as
+ * starting threads would cost more than it saves.
+ */
+template <typename CharT, std::random_access_iterator It, typename Flags,
+          std::output_iterator<parser::Result<CharT>> Out>
+Out parse(const parser::Parser<CharT, It, Flags> &parser, Out out,
+          unsigned threads = std::thread::hardware_concurrency()) {
+  constexpr std::size_t minimum_chunk = 1 << 14;
+  constexpr auto long_prefix = parser::Separators<CharT>::long_prefix;
+  constexpr auto short_prefix = parser::Separators<CharT>::short_prefix;
+  constexpr auto long_value_separator =
+      parser::Separators<CharT>::long_value_separator;
+
+  const auto args = parser.base();
+  const auto arguments = args.begin();
+  const auto count = static_cast<std::size_t>(args.size());
+  const auto &flags = parser.flags();
+
+  const auto argument = [&](const std::size_t i) {
+    return std::basic_string_view<CharT>(arguments[i]);
+  };
+
+  std::vector<Classification> classifications(count);
+  const auto classify_chunk = [&](const std::size_t begin,
+                                  const std::size_t end) noexcept {
+    for (auto i = begin; i < end; ++i) {
+      classifications[i] = classify(argument(i), flags);
+    }
+  };
+
+  const auto chunks = std::clamp<std::size_t>(count / minimum_chunk, 1,
+                                              std::max(threads, 1u));
+  const auto chunk_size = (count + chunks - 1) / chunks;
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(chunks - 1);
+    for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+      workers.emplace_back(classify_chunk, chunk * chunk_size,
+                           std::min(count, (chunk + 1) * chunk_size));
+    }
+    classify_chunk(0, std::min(count, chunk_size));
+  }
+
+  const auto emit = [&](parser::Result<CharT> result) {
+    *out = std::move(result);
+    ++out;
+  };
+
+  bool positional_only = false;
+  for (std::size_t i = 0; i < count;) {
+    const auto arg = argument(i);
+    const auto &classification = classifications[i];
+
+    if (positional_only || classification.shape == Shape::positional) {
+      emit(parser::Positional<CharT>(arg));
+      ++i;
+    } else if (classification.shape == Shape::separator) {
+      positional_only = true;
+      ++i;
+    } else if (classification.shape == Shape::long_flag) {
+      const auto long_block = arg.substr(long_prefix.size());
+      const auto flag = long_block.substr(0, classification.split);
+      // Looking abbreviations up again is cheaper than keeping every match.
+      const auto match =
+          classification.abbreviated
+              ? parser::detail::long_match(flags, flag)
+              : parser::LongMatch<CharT>{classification.kind, flag, {}};
+      const bool has_value = classification.split != Classification::no_value;
+      const auto value =
+          has_value ? long_block.substr(classification.split +
+                                        long_value_separator.size())
+                    : std::basic_string_view<CharT>{};
+      ++i;
+
+      switch (match.kind) {
+      case parser::FlagKind::flag:
+        if (has_value) {
+          emit(parser::UnexpectedValueError<CharT>(
+              parser::LongValueFlag<CharT>(match.flag, value)));
+          return out;
+        }
+        emit(parser::LongFlag<CharT>(match.flag));
+        break;
+      case parser::FlagKind::value_flag:
+        if (has_value) {
+          emit(parser::LongValueFlag<CharT>(match.flag, value));
+        } else if (i == count) {
+          emit(parser::ExpectedValueError<CharT>(
+              parser::LongFlag<CharT>(match.flag)));
+        } else {
+          emit(parser::LongValueFlag<CharT>(match.flag, argument(i)));
+          ++i;
+        }
+        break;
+      default:
+        if (!match.candidates.empty()) {
+          emit(parser::AmbiguousFlagError<CharT>{parser::LongFlag<CharT>(flag),
+                                                 match.candidates});
+        } else {
+          emit(parser::UnknownFlagError<CharT>(parser::LongFlag<CharT>(flag)));
+        }
+        return out;
+      }
+    } else {
+      const auto short_flags_block = arg.substr(short_prefix.size());
+      for (std::size_t j = 0; j < classification.split; ++j) {
+        emit(parser::ShortFlag<CharT>(short_flags_block[j]));
+      }
+      ++i;
+      if (classification.split == short_flags_block.size()) {
+        continue;
+      }
+
+      const auto flag = short_flags_block[classification.split];
+      const auto value = short_flags_block.substr(classification.split + 1);
+      if (classification.kind == parser::FlagKind::value_flag) {
+        if (!value.empty()) {
+          emit(parser::ShortValueFlag<CharT>(flag, value));
+        } else if (i == count) {
+          emit(parser::ExpectedValueError<CharT>(
+              parser::ShortFlag<CharT>(flag)));
+        } else {
+          emit(parser::ShortValueFlag<CharT>(flag, argument(i)));
+          ++i;
+        }
+      } else {
+        emit(parser::UnknownFlagError<CharT>(parser::ShortFlag<CharT>(flag)));
+        return out;
+      }
+    }
+  }
+  return out;
+}
+} // namespace parallel
+} // namespace args2
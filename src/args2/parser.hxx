@@ -1,4 +1,10 @@
+#pragma once
+
+#include <algorithm>
+#include <args2/flags.hxx>
+#include <compare>
 #include <concepts>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <iostream>
@@ -6,9 +12,12 @@
 #include <memory>
 #include <optional>
 #include <ranges>
+#include <span>
 #include <string_view>
+#include <type_traits>
 #include <uchar.h>
 #include <unordered_set>
+#include <utility>
 #include <variant>
 
 namespace args2 {
@@ -164,18 +173,214 @@ template <typename CharT> struct UnknownFlagError {
   auto operator<=>(const UnknownFlagError &) const noexcept = default;
 };
 
+// Got a long flag that abbreviates more than one known flag.  The candidates
+// are views into the flag lookup, so listing them doesn't allocate.
+template <typename CharT> struct AmbiguousFlagError {
+  LongFlag<CharT> flag;
+  std::span<const std::basic_string_view<CharT>> candidates;
+
+  constexpr bool operator==(const AmbiguousFlagError &other) const noexcept {
+    return flag == other.flag &&
+           std::ranges::equal(candidates, other.candidates);
+  }
+
+  constexpr std::strong_ordering
+  operator<=>(const AmbiguousFlagError &other) const noexcept {
+    if (const auto order = flag <=> other.flag; order != 0) {
+      return order;
+    }
+    return std::lexicographical_compare_three_way(
+        candidates.begin(), candidates.end(), other.candidates.begin(),
+        other.candidates.end());
+  }
+};
+
+/** Why a value could not be converted.
+ */
+enum class InvalidValue : unsigned char {
+  // Not a value of the wanted type at all.
+  malformed,
+
+  // A value of the wanted type, but one that it can't represent.
+  out_of_range,
+
+  // A list with more elements than there is room for.
+  too_many,
+};
+
+// If a value couldn't be converted to what its flag wants.  The parser never
+// returns this itself; value conversions do.
+template <typename CharT> struct InvalidValueError {
+  std::variant<ShortValueFlag<CharT>, LongValueFlag<CharT>> flag;
+  InvalidValue reason;
+
+  auto operator<=>(const InvalidValueError &) const noexcept = default;
+};
+
 template <typename CharT>
 using Error =
     std::variant<ExpectedValueError<CharT>, UnexpectedValueError<CharT>,
-                 UnknownFlagError<CharT>>;
+                 UnknownFlagError<CharT>, AmbiguousFlagError<CharT>,
+                 InvalidValueError<CharT>>;
 
 template <typename CharT>
 using Result = std::variant<Token<CharT>, Error<CharT>>;
 
-template <typename CharT, std::input_iterator It>
+/** Which Result alternative a PackedResult stands for.
+ */
+enum class PackedKind : unsigned char {
+  short_flag,
+  long_flag,
+  short_value_flag,
+  long_value_flag,
+  positional,
+  expected_short_value,
+  expected_long_value,
+  unexpected_short_value,
+  unexpected_long_value,
+  unknown_short_flag,
+  unknown_long_flag,
+  ambiguous_long_flag,
+  invalid_short_value,
+  invalid_long_value,
+};
+
+/** A compact, flat encoding of a Result, as written by Parser::parse_all.
+ * Rather than holding string_views, it records where the flag and value are
+ * in the original arguments: the index of the argument holding the flag (or
+ * the positional), and offsets and lengths into it.  A value may instead be
+ * the whole next argument.  It is the same size for every character type,
+ * and can be unpacked into a Result on demand, given the same arguments, or
+ * an iterator to its own argument when they can't be indexed.
+ *
+ * Arguments, and offsets into them, must fit in 32 bits.
+ */
+template <typename CharT> struct PackedResult {
+  std::uint32_t index = 0;
+  std::uint32_t flag_offset = 0;
+  std::uint32_t flag_length = 0;
+  std::uint32_t value_offset = 0;
+  std::uint32_t value_length = 0;
+  PackedKind kind = PackedKind::positional;
+
+  // The value is at the start of the argument after index.
+  bool value_next = false;
+
+  // Only for invalid values.
+  InvalidValue reason = InvalidValue::malformed;
+
+  auto operator<=>(const PackedResult &) const noexcept = default;
+
+  /** Rebuild the Result, with string_views into args.  Long flags are as they
+   * were written, so abbreviations are not expanded, and ambiguous flags have
+   * no candidates.
+   */
+  template <std::ranges::random_access_range Args>
+    requires std::convertible_to<std::ranges::range_reference_t<const Args>,
+                                 std::basic_string_view<CharT>>
+  constexpr Result<CharT> unpack(const Args &args) const noexcept {
+    return unpack(std::ranges::next(std::ranges::begin(args), index));
+  }
+
+  /** Rebuild the Result from argument, an iterator to the argument at index,
+   * for arguments that can't be indexed.  Packed results are in argument
+   * order, so a single pass over the arguments can unpack all of them.
+   */
+  template <std::forward_iterator Argument>
+    requires std::convertible_to<std::iter_reference_t<Argument>,
+                                 std::basic_string_view<CharT>>
+  constexpr Result<CharT> unpack(const Argument argument) const noexcept {
+    return rebuild(argument, [](const std::basic_string_view<CharT> flag) {
+      return LongMatch<CharT>{FlagKind::unknown, flag, {}};
+    });
+  }
+
+  /** Rebuild the Result exactly as the parser returned it, looking long flags
+   * up again in flags, which must be the parser's flags.
+   */
+  template <std::ranges::random_access_range Args, FlagLookup<CharT> Flags>
+    requires std::convertible_to<std::ranges::range_reference_t<const Args>,
+                                 std::basic_string_view<CharT>>
+  constexpr Result<CharT> unpack(const Args &args,
+                                 const Flags &flags) const noexcept {
+    return unpack(std::ranges::next(std::ranges::begin(args), index), flags);
+  }
+
+  /** Rebuild the Result exactly as the parser returned it from argument, an
+   * iterator to the argument at index.
+   */
+  template <std::forward_iterator Argument, FlagLookup<CharT> Flags>
+    requires std::convertible_to<std::iter_reference_t<Argument>,
+                                 std::basic_string_view<CharT>>
+  constexpr Result<CharT> unpack(const Argument argument,
+                                 const Flags &flags) const noexcept {
+    return rebuild(argument, [&](const std::basic_string_view<CharT> flag) {
+      return detail::long_match(flags, flag);
+    });
+  }
+
+private:
+  template <typename Argument, typename Match>
+  constexpr Result<CharT> rebuild(const Argument argument,
+                                  const Match &match) const noexcept {
+    const std::basic_string_view<CharT> arg = *argument;
+    const auto flag = arg.substr(flag_offset, flag_length);
+    const auto value =
+        value_next ? std::basic_string_view<CharT>(*std::next(argument))
+                         .substr(value_offset, value_length)
+                   : arg.substr(value_offset, value_length);
+
+    switch (kind) {
+    case PackedKind::short_flag:
+      return ShortFlag<CharT>(flag.front());
+    case PackedKind::long_flag:
+      return LongFlag<CharT>(match(flag).flag);
+    case PackedKind::short_value_flag:
+      return ShortValueFlag<CharT>(flag.front(), value);
+    case PackedKind::long_value_flag:
+      return LongValueFlag<CharT>(match(flag).flag, value);
+    case PackedKind::positional:
+      return Positional<CharT>(value);
+    case PackedKind::expected_short_value:
+      return ExpectedValueError<CharT>(ShortFlag<CharT>(flag.front()));
+    case PackedKind::expected_long_value:
+      return ExpectedValueError<CharT>(LongFlag<CharT>(match(flag).flag));
+    case PackedKind::unexpected_short_value:
+      return UnexpectedValueError<CharT>(
+          ShortValueFlag<CharT>(flag.front(), value));
+    case PackedKind::unexpected_long_value:
+      return UnexpectedValueError<CharT>(
+          LongValueFlag<CharT>(match(flag).flag, value));
+    case PackedKind::unknown_short_flag:
+      return UnknownFlagError<CharT>(ShortFlag<CharT>(flag.front()));
+    case PackedKind::unknown_long_flag:
+      return UnknownFlagError<CharT>(LongFlag<CharT>(flag));
+    case PackedKind::ambiguous_long_flag:
+      return AmbiguousFlagError<CharT>{LongFlag<CharT>(flag),
+                                       match(flag).candidates};
+    case PackedKind::invalid_short_value:
+      return InvalidValueError<CharT>(
+          ShortValueFlag<CharT>(flag.front(), value), reason);
+    default:
+      return InvalidValueError<CharT>(LongValueFlag<CharT>(flag, value),
+                                      reason);
+    }
+  }
+};
+
+template <typename CharT, std::input_iterator It,
+          FlagLookup<CharT> Flags = SetFlags<CharT>>
+  requires std::convertible_to<std::iter_value_t<It>,
+                               std::basic_string_view<CharT>>
+class Parser;
+
+template <typename CharT, std::input_iterator It,
+          FlagLookup<CharT> Flags = SetFlags<CharT>>
   requires std::convertible_to<std::iter_value_t<It>,
                                std::basic_string_view<CharT>>
 class Iterator {
+  friend class Parser<CharT, It, Flags>;
+
 private:
   It it;
 
@@ -183,10 +388,9 @@ private:
   // without moving past the end.
   It end;
 
-  const std::unordered_set<CharT> *short_flags;
-  const std::unordered_set<CharT> *short_value_flags;
-  const std::unordered_set<std::basic_string_view<CharT>> *long_flags;
-  const std::unordered_set<std::basic_string_view<CharT>> *long_value_flags;
+  // Handles are held directly, anything else is referred to in the parser.
+  std::conditional_t<enable_borrowed_flags<Flags>, Flags, FlagsRef<Flags>>
+      flags;
 
   // Triggered after a -- is encountered
   bool positional_only = false;
@@ -202,7 +406,7 @@ private:
   /** Load in the next item to be fetched on a dereference, like a Rust
    * Iterator.
    */
-  std::optional<Result<CharT>> next() noexcept {
+  constexpr std::optional<Result<CharT>> next() noexcept {
     constexpr auto positional_separator =
         Separators<CharT>::positional_separator;
     constexpr auto long_prefix = Separators<CharT>::long_prefix;
@@ -234,10 +438,11 @@ private:
           ++it;
         }
 
-        if (short_flags->count(flag)) {
+        switch (flags.short_kind(flag)) {
+        case FlagKind::flag:
           // no value
           return ShortFlag<CharT>(flag);
-        } else if (short_value_flags->count(flag)) {
+        case FlagKind::value_flag:
           if (!short_flags_block.empty()) {
             // need value, attached to short flag block
             auto value = short_flags_block;
@@ -253,7 +458,7 @@ private:
             ++it;
             return ShortValueFlag<CharT>(flag, arg);
           }
-        } else {
+        default:
           short_flags_block = std::basic_string_view<CharT>{};
           it = end;
           return UnknownFlagError<CharT>(ShortFlag<CharT>(flag));
@@ -283,33 +488,39 @@ private:
                                     long_value_separator.size());
         }
 
-        if (long_flags->count(flag)) {
+        const auto match = detail::long_match(flags, flag);
+        switch (match.kind) {
+        case FlagKind::flag:
           if (value) {
             // got attached value that we didn't want
             short_flags_block = std::basic_string_view<CharT>{};
             it = end;
             return UnexpectedValueError<CharT>(
-                LongValueFlag<CharT>(flag, *value));
+                LongValueFlag<CharT>(match.flag, *value));
           } else {
             // no value
-            return LongFlag<CharT>(flag);
+            return LongFlag<CharT>(match.flag);
           }
-        } else if (long_value_flags->count(flag)) {
+        case FlagKind::value_flag:
           if (value) {
             // attached value
-            return LongValueFlag<CharT>(flag, *value);
+            return LongValueFlag<CharT>(match.flag, *value);
           } else if (it == end) {
             // needed a value but none was attached or available
-            return ExpectedValueError<CharT>(LongFlag<CharT>(flag));
+            return ExpectedValueError<CharT>(LongFlag<CharT>(match.flag));
           } else {
             // get value from next arg
             const std::basic_string_view<CharT> arg = *it;
             ++it;
-            return LongValueFlag<CharT>(flag, arg);
+            return LongValueFlag<CharT>(match.flag, arg);
           }
-        } else {
+        default:
           short_flags_block = std::basic_string_view<CharT>{};
           it = end;
+          if (!match.candidates.empty()) {
+            return AmbiguousFlagError<CharT>{LongFlag<CharT>(flag),
+                                             match.candidates};
+          }
           return UnknownFlagError<CharT>(LongFlag<CharT>(flag));
         }
       } else if (arg.size() > short_prefix.size() &&
@@ -325,65 +536,92 @@ private:
   }
 
 public:
-  Iterator(It it, It end, const std::unordered_set<CharT> *short_flags,
-           const std::unordered_set<CharT> *short_value_flags,
-           const std::unordered_set<std::basic_string_view<CharT>> *long_flags,
-           const std::unordered_set<std::basic_string_view<CharT>>
-               *long_value_flags) noexcept
-      : it(it), end(end), short_flags(short_flags), long_flags(long_flags),
-        short_value_flags(short_value_flags),
-        long_value_flags(long_value_flags) {
+  constexpr Iterator(It it, It end, const Flags &flags) noexcept
+      : it(it), end(end), flags(flags) {
     current_item = next();
   }
-  Iterator() noexcept {}
+  constexpr Iterator() noexcept {}
 
-  bool operator==(const Iterator &other) const noexcept {
+  constexpr bool operator==(const Iterator &other) const noexcept {
     // Special case for default-constructed end iterator
     return (it == end && other.it == other.end && !current_item &&
             !other.current_item) ||
            (it == other.it && short_flags_block == other.short_flags_block &&
             current_item == other.current_item);
   }
-  bool operator!=(const Iterator &other) const noexcept = default;
+  constexpr bool operator!=(const Iterator &other) const noexcept = default;
 
-  const Result<CharT> &operator*() const noexcept { return *current_item; }
+  /** The end check.  Only needs to know whether there is a current item.
+   */
+  constexpr bool operator==(std::default_sentinel_t) const noexcept {
+    return !current_item;
+  }
+
+  constexpr const Result<CharT> &operator*() const noexcept {
+    return *current_item;
+  }
 
-  Iterator &operator++() noexcept {
+  constexpr Iterator &operator++() noexcept {
     current_item = next();
     return *this;
   }
-  Iterator operator++(int) noexcept {
+  constexpr Iterator operator++(int) noexcept {
     auto prev = *this;
     current_item = next();
     return prev;
   }
 };
 
-template <typename CharT, std::input_iterator It>
+/** The parser range.
+ * Flags is anything that can classify flags.  The default owns four hash sets,
+ * a Schema or StaticSchema fixes the flag set at compile time, and a FlagsRef
+ * refers to a shared FlagTable, so that making a parser never allocates.
+ *
+ * The parser is a range that ends in a default_sentinel_t.  With a
+ * StaticSchema or FlagsRef it is also a view and a borrowed range, as it
+ * copies in constant time and its iterators don't refer back into it.  Other
+ * parsers own their flags, so range adaptors refer to them, or take them over
+ * when they are rvalues, instead of copying them.
+ */
+template <typename CharT, std::input_iterator It, FlagLookup<CharT> Flags>
   requires std::convertible_to<std::iter_value_t<It>,
                                std::basic_string_view<CharT>>
-class Parser {
+class Parser
+    : public std::ranges::view_interface<Parser<CharT, It, Flags>> {
 public:
-  using iterator = Iterator<CharT, It>;
+  using iterator = Iterator<CharT, It, Flags>;
+  using sentinel = std::default_sentinel_t;
 
 private:
   It begin_;
   It end_;
 
-  std::unordered_set<CharT> short_flags;
-  std::unordered_set<CharT> short_value_flags;
-  std::unordered_set<std::basic_string_view<CharT>> long_flags;
-  std::unordered_set<std::basic_string_view<CharT>> long_value_flags;
+  Flags flags_;
 
 public:
+  constexpr Parser(It begin, It end, Flags flags = Flags()) noexcept
+      : begin_(begin), end_(end), flags_(std::move(flags)) {}
+
+  /** A parser with no arguments yet, to be given some with reset or parse.
+   */
+  constexpr explicit Parser(Flags flags) noexcept
+    requires std::default_initializable<It>
+      : flags_(std::move(flags)) {}
+
+  constexpr Parser(const std::ranges::range auto &range,
+                   Flags flags = Flags()) noexcept
+      : begin_(std::ranges::begin(range)), end_(std::ranges::end(range)),
+        flags_(std::move(flags)) {}
+
   Parser(It begin, It end, std::unordered_set<CharT> short_flags,
          std::unordered_set<CharT> short_value_flags,
          std::unordered_set<std::basic_string_view<CharT>> long_flags,
          std::unordered_set<std::basic_string_view<CharT>>
              long_value_flags) noexcept
-      : begin_(begin), end_(end), short_flags(short_flags),
-        long_flags(long_flags), short_value_flags(short_value_flags),
-        long_value_flags(long_value_flags) {}
+    requires std::same_as<Flags, SetFlags<CharT>>
+      : begin_(begin), end_(end),
+        flags_{std::move(short_flags), std::move(short_value_flags),
+              std::move(long_flags), std::move(long_value_flags)} {}
 
   Parser(const std::ranges::range auto &range,
          std::unordered_set<CharT> short_flags,
@@ -391,31 +629,211 @@ public:
          std::unordered_set<std::basic_string_view<CharT>> long_flags,
          std::unordered_set<std::basic_string_view<CharT>>
              long_value_flags) noexcept
+    requires std::same_as<Flags, SetFlags<CharT>>
       : begin_(std::ranges::begin(range)), end_(std::ranges::end(range)),
-        short_flags(short_flags), long_flags(long_flags),
-        short_value_flags(short_value_flags),
-        long_value_flags(long_value_flags) {}
+        flags_{std::move(short_flags), std::move(short_value_flags),
+              std::move(long_flags), std::move(long_value_flags)} {}
+
+  constexpr iterator begin() const noexcept {
+    return iterator(begin_, end_, flags_);
+  }
 
-  iterator begin() const noexcept {
-    return iterator(begin_, end_, &short_flags, &short_value_flags, &long_flags,
-                    &long_value_flags);
+  constexpr sentinel end() const noexcept { return std::default_sentinel; }
+
+  /** The arguments being parsed.
+   */
+  constexpr std::ranges::subrange<It> base() const noexcept {
+    return {begin_, end_};
+  }
+
+  constexpr const Flags &flags() const noexcept { return flags_; }
+
+  /** Point the parser at other arguments, keeping its flags, so that a
+   * long-lived parser can take command line after command line without
+   * building its flag lookup again.  Iterators from before keep parsing the
+   * arguments they started with.
+   */
+  constexpr void reset(It begin, It end) noexcept {
+    begin_ = begin;
+    end_ = end;
   }
 
-  iterator end() const noexcept {
-    return iterator(end_, end_, &short_flags, &short_value_flags, &long_flags,
-                    &long_value_flags);
+  /** Reset the parser to range, and return it for iteration.
+   */
+  constexpr Parser &parse(const std::ranges::range auto &range) noexcept {
+    reset(std::ranges::begin(range), std::ranges::end(range));
+    return *this;
+  }
+
+  /** Parse all arguments in a single pass, writing a PackedResult for each
+   * Result to out, which may be a caller-owned buffer or an inserter into an
+   * arena-backed container.  Returns the advanced output iterator.
+   * The packed results can be scanned any number of times, from any number of
+   * threads, and unpacked against the same arguments, by index when they are
+   * random access, or from an iterator to each result's argument otherwise.
+   */
+  template <std::output_iterator<PackedResult<CharT>> Out>
+    requires std::forward_iterator<It>
+  constexpr Out parse_all(Out out) const {
+    constexpr auto positional_separator =
+        Separators<CharT>::positional_separator;
+    constexpr auto long_prefix = Separators<CharT>::long_prefix;
+    constexpr auto short_prefix = Separators<CharT>::short_prefix;
+    constexpr auto long_value_separator =
+        Separators<CharT>::long_value_separator;
+
+    iterator parsed(begin_, end_, flags_);
+
+    // The iterator state that the current item was parsed from.
+    It base = begin_;
+    std::uint32_t index = 0;
+    std::basic_string_view<CharT> short_flags_block;
+    bool positional_only = false;
+
+    while (parsed.current_item) {
+      const std::basic_string_view<CharT> arg = *base;
+      PackedResult<CharT> packed;
+      packed.index = index;
+
+      const auto offset = [&](const std::basic_string_view<CharT> part) {
+        return static_cast<std::uint32_t>(part.data() - arg.data());
+      };
+      const auto short_flag = [&] {
+        packed.flag_offset = short_flags_block.empty()
+                                 ? short_prefix.size()
+                                 : offset(short_flags_block);
+        packed.flag_length = 1;
+      };
+      // Long flags may have been expanded from an abbreviation, so they are
+      // recorded as written, always right after the prefix.
+      const auto long_flag = [&] {
+        const auto long_block = arg.substr(long_prefix.size());
+        packed.flag_offset = long_prefix.size();
+        packed.flag_length = std::min(long_block.find(long_value_separator),
+                                      long_block.size());
+      };
+      // Values are either attached to the end of the flag's argument, or the
+      // whole next argument.
+      const auto value = [&](const std::basic_string_view<CharT> value) {
+        packed.value_next =
+            packed.flag_offset + packed.flag_length == arg.size();
+        packed.value_offset = packed.value_next ? 0 : offset(value);
+        packed.value_length = value.size();
+      };
+
+      const auto pack = [&]<typename Item>(const Item &item) {
+        if constexpr (std::same_as<Item, ShortFlag<CharT>>) {
+          packed.kind = PackedKind::short_flag;
+          short_flag();
+        } else if constexpr (std::same_as<Item, LongFlag<CharT>>) {
+          packed.kind = PackedKind::long_flag;
+          long_flag();
+        } else if constexpr (std::same_as<Item, ShortValueFlag<CharT>>) {
+          packed.kind = PackedKind::short_value_flag;
+          short_flag();
+          value(item.value);
+        } else if constexpr (std::same_as<Item, LongValueFlag<CharT>>) {
+          packed.kind = PackedKind::long_value_flag;
+          long_flag();
+          value(item.value);
+        } else if constexpr (std::same_as<Item, Positional<CharT>>) {
+          packed.kind = PackedKind::positional;
+          if (!positional_only && short_flags_block.empty() &&
+              arg == positional_separator) {
+            // The separator was skipped to get here.
+            ++packed.index;
+          }
+          packed.value_length = item.value.size();
+        } else if constexpr (std::same_as<Item, ExpectedValueError<CharT>>) {
+          if (std::holds_alternative<ShortFlag<CharT>>(item.flag)) {
+            packed.kind = PackedKind::expected_short_value;
+            short_flag();
+          } else {
+            packed.kind = PackedKind::expected_long_value;
+            long_flag();
+          }
+        } else if constexpr (std::same_as<Item, UnexpectedValueError<CharT>>) {
+          if (const auto short_value_flag =
+                  std::get_if<ShortValueFlag<CharT>>(&item.flag)) {
+            packed.kind = PackedKind::unexpected_short_value;
+            short_flag();
+            value(short_value_flag->value);
+          } else {
+            const auto &long_value_flag =
+                std::get<LongValueFlag<CharT>>(item.flag);
+            packed.kind = PackedKind::unexpected_long_value;
+            long_flag();
+            value(long_value_flag.value);
+          }
+        } else if constexpr (std::same_as<Item, UnknownFlagError<CharT>>) {
+          if (std::holds_alternative<ShortFlag<CharT>>(item.flag)) {
+            packed.kind = PackedKind::unknown_short_flag;
+            short_flag();
+          } else {
+            packed.kind = PackedKind::unknown_long_flag;
+            long_flag();
+          }
+        } else if constexpr (std::same_as<Item, AmbiguousFlagError<CharT>>) {
+          packed.kind = PackedKind::ambiguous_long_flag;
+          long_flag();
+        } else {
+          packed.reason = item.reason;
+          if (const auto short_value_flag =
+                  std::get_if<ShortValueFlag<CharT>>(&item.flag)) {
+            packed.kind = PackedKind::invalid_short_value;
+            short_flag();
+            value(short_value_flag->value);
+          } else {
+            const auto &long_value_flag =
+                std::get<LongValueFlag<CharT>>(item.flag);
+            packed.kind = PackedKind::invalid_long_value;
+            long_flag();
+            value(long_value_flag.value);
+          }
+        }
+      };
+      std::visit([&](const auto &result) { std::visit(pack, result); },
+                 *parsed.current_item);
+
+      *out = packed;
+      ++out;
+
+      index += std::ranges::distance(base, parsed.it);
+      base = parsed.it;
+      short_flags_block = parsed.short_flags_block;
+      positional_only = parsed.positional_only;
+      ++parsed;
+    }
+    return out;
   }
 };
+
+template <std::ranges::range Range, typename CharT>
+Parser(const Range &, const FlagTable<CharT> &)
+    -> Parser<CharT, std::ranges::iterator_t<const Range>,
+              FlagsRef<FlagTable<CharT>>>;
 } // namespace parser
 } // namespace args2
 
+namespace std::ranges {
+template <typename CharT, std::input_iterator It, typename Flags>
+inline constexpr bool
+    enable_borrowed_range<args2::parser::Parser<CharT, It, Flags>> =
+        args2::parser::enable_borrowed_flags<Flags>;
+
+template <typename CharT, std::input_iterator It, typename Flags>
+inline constexpr bool enable_view<args2::parser::Parser<CharT, It, Flags>> =
+    args2::parser::enable_borrowed_flags<Flags>;
+} // namespace std::ranges
+
 namespace std {
-template <typename CharT, std::input_iterator It>
-  requires std::convertible_to<std::iter_value_t<It>,
-                               std::basic_string_view<CharT>>
-struct iterator_traits<args2::parser::Iterator<CharT, It>> {
-  using iterator_concept = std::forward_iterator_tag;
-  using iterator_category = std::forward_iterator_tag;
+template <typename CharT, std::input_iterator It, typename Flags>
+struct iterator_traits<args2::parser::Iterator<CharT, It, Flags>> {
+  // Only as good as the arguments, which may be single-pass.
+  using iterator_concept =
+      std::conditional_t<std::forward_iterator<It>, std::forward_iterator_tag,
+                         std::input_iterator_tag>;
+  using iterator_category = iterator_concept;
   using value_type = args2::parser::Result<CharT>;
   using difference_type = ssize_t;
   using pointer = const args2::parser::Result<CharT> *;
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <args2/split.hxx>
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace args2 {
+namespace response {
+/** A file mapped into memory, so that its arguments can be parsed straight
+ * out of the page cache.  The mapping is private and writable: pages are only
+ * copied if something writes to them, like shell unquoting does, and the file
+ * itself is never modified.
+ */
+class MappedFile {
+private:
+  std::byte *data_ = nullptr;
+  std::size_t size_ = 0;
+
+public:
+  MappedFile() noexcept = default;
+
+  /** Map the file at path.  On failure, error is set and the file is empty.
+   */
+  MappedFile(const std::filesystem::path &path,
+             std::error_code &error) noexcept {
+    error.clear();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+      error.assign(errno, std::generic_category());
+      return;
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) == -1) {
+      error.assign(errno, std::generic_category());
+    } else if (!S_ISREG(status.st_mode)) {
+      error = std::make_error_code(std::errc::invalid_argument);
+    } else if (status.st_size > 0) {
+      const auto size = static_cast<std::size_t>(status.st_size);
+      void *const data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        error.assign(errno, std::generic_category());
+      } else {
+        ::madvise(data, size, MADV_SEQUENTIAL);
+        data_ = static_cast<std::byte *>(data);
+        size_ = size;
+      }
+    }
+    ::close(fd);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile(MappedFile &&other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  MappedFile &operator=(MappedFile &&other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+
+  ~MappedFile() {
+    if (data_) {
+      ::munmap(data_, size_);
+    }
+  }
+
+  /** The mapped contents as characters.  Any trailing partial character is
+   * left out.
+   */
+  template <typename CharT> std::span<CharT> chars() const noexcept {
+    return std::span<CharT>(reinterpret_cast<CharT *>(data_),
+                            size_ / sizeof(CharT));
+  }
+};
+
+/** How the arguments in a response file are separated.
+ */
+enum class Format {
+  // Separated by NUL characters.  The file is never written to.
+  nul,
+
+  // Separated by whitespace, with shell quoting.
+  shell,
+};
+
+template <typename CharT, std::forward_iterator It, Format format>
+  requires std::convertible_to<std::iter_value_t<It>,
+                               std::basic_string_view<CharT>>
+class Expand;
+
+/** Iterates the arguments of an Expand range.
+ * All end Iterators of the same range compare equal.
+ */
+template <typename CharT, std::forward_iterator It, Format format>
+  requires std::convertible_to<std::iter_value_t<It>,
+                               std::basic_string_view<CharT>>
+class ExpandIterator {
+  friend class Expand<CharT, It, format>;
+
+private:
+  // NUL-separated files are split as they are read, as that never writes to
+  // them.  Shell files are split once, up front, and their arguments kept.
+  using Inner =
+      std::conditional_t<format == Format::nul, split::NulIterator<CharT>,
+                         std::span<const std::basic_string_view<CharT>>>;
+
+  const Expand<CharT, It, format> *expand = nullptr;
+
+  // The next outer argument.  While in a response file, this is already past
+  // the @file argument.
+  It outer;
+
+  // The rest of the current response file.  Exhausted when not in one.
+  Inner inner;
+
+  static bool exhausted(const Inner &inner) noexcept {
+    if constexpr (format == Format::nul) {
+      return inner == Inner();
+    } else {
+      return inner.empty();
+    }
+  }
+
+  /** Move to the next argument, entering response files as they come up.
+   * inner must be exhausted, or hold the next argument.
+   */
+  void settle() noexcept {
+    constexpr CharT response_prefix('@');
+
+    while (exhausted(inner) && outer != expand->end_) {
+      const std::basic_string_view<CharT> arg = *outer;
+      if (arg.size() <= 1 || arg.front() != response_prefix) {
+        return;
+      }
+      const auto file = expand->map(arg);
+      if (!file) {
+        // Can't be read, so it is passed on as it is.
+        return;
+      }
+      ++outer;
+      inner = *file;
+    }
+  }
+
+public:
+  ExpandIterator(const Expand<CharT, It, format> *expand, It outer) noexcept
+      : expand(expand), outer(outer) {
+    settle();
+  }
+  ExpandIterator() noexcept {}
+
+  std::basic_string_view<CharT> operator*() const noexcept {
+    if (!exhausted(inner)) {
+      if constexpr (format == Format::nul) {
+        return *inner;
+      } else {
+        return inner.front();
+      }
+    }
+    return *outer;
+  }
+
+  ExpandIterator &operator++() noexcept {
+    if (exhausted(inner)) {
+      ++outer;
+    } else if constexpr (format == Format::nul) {
+      ++inner;
+    } else {
+      inner = inner.subspan(1);
+    }
+    settle();
+    return *this;
+  }
+  ExpandIterator operator++(int) noexcept {
+    auto prev = *this;
+    ++(*this);
+    return prev;
+  }
+
+  bool operator==(const ExpandIterator &other) const noexcept {
+    if constexpr (format == Format::nul) {
+      return outer == other.outer && inner == other.inner;
+    } else {
+      // Spans left empty by stepping past their end still point somewhere.
+      if (exhausted(inner) || exhausted(other.inner)) {
+        return outer == other.outer && exhausted(inner) &&
+               exhausted(other.inner);
+      }
+      return outer == other.outer && inner.data() == other.inner.data() &&
+             inner.size() == other.inner.size();
+    }
+  }
+};
+
+/** An argument range that expands `@file` arguments in place with the
+ * arguments in that file, like GCC does, so that argument lists can grow past
+ * the kernel's ARG_MAX.  Response files are memory mapped and split in place,
+ * so their arguments are views straight into the mapped pages and are never
+ * copied.  A `@file` that can't be read is passed on as it is, and response
+ * files are not expanded recursively.
+ *
+ * Each response file is mapped once per range, the first time it comes up,
+ * and shell files are unquoted once and their argument views kept, so the
+ * range can be iterated any number of times and a file named twice is only
+ * read once.  Mappings are kept for the lifetime of the range, so arguments
+ * stay valid as long as it does.  Iterating a const range still maps files, so
+ * one range should not be iterated from several threads at once.
+ */
+template <typename CharT, std::forward_iterator It, Format format>
+  requires std::convertible_to<std::iter_value_t<It>,
+                               std::basic_string_view<CharT>>
+class Expand {
+  friend class ExpandIterator<CharT, It, format>;
+
+public:
+  using iterator = ExpandIterator<CharT, It, format>;
+
+private:
+  struct Mapping {
+    MappedFile file;
+
+    // Only for the shell format.
+    std::vector<std::basic_string_view<CharT>> args;
+
+    bool readable = false;
+  };
+
+  It begin_;
+  It end_;
+
+  // Keyed by the @file argument itself, which outlives the range.  Filled in
+  // as the range is iterated.
+  mutable std::unordered_map<std::basic_string_view<CharT>, Mapping> files;
+
+  mutable std::error_code error_;
+
+  /** The contents of the response file named by argument, mapping it on first
+   * use, or nothing if it can't be read.
+   */
+  std::optional<typename iterator::Inner>
+  map(const std::basic_string_view<CharT> argument) const noexcept {
+    Mapping *mapping;
+    try {
+      auto [found, inserted] = files.try_emplace(argument);
+      mapping = &found->second;
+      if (inserted) {
+        std::error_code error;
+        mapping->file = MappedFile(
+            std::filesystem::path(argument.substr(1)), error);
+        if (error) {
+          error_ = error;
+          return std::nullopt;
+        }
+        if constexpr (format == Format::shell) {
+          for (const auto arg : split::Shell<CharT>(
+                   mapping->file.template chars<CharT>())) {
+            mapping->args.push_back(arg);
+          }
+        }
+        mapping->readable = true;
+      }
+    } catch (const std::system_error &exception) {
+      error_ = exception.code();
+      return std::nullopt;
+    } catch (const std::bad_alloc &) {
+      error_ = std::make_error_code(std::errc::not_enough_memory);
+      return std::nullopt;
+    }
+
+    if (!mapping->readable) {
+      return std::nullopt;
+    }
+    if constexpr (format == Format::nul) {
+      const auto contents = mapping.file.template chars<CharT>();
+      return split::NulIterator<CharT>(
+          std::basic_string_view<CharT>(contents.data(), contents.size()));
+    } else {
+      return mapping->args;
+    }
+  }
+
+public:
+  Expand(It begin, It end) noexcept : begin_(begin), end_(end) {}
+
+  Expand(const std::ranges::range auto &range) noexcept
+      : begin_(std::ranges::begin(range)), end_(std::ranges::end(range)) {}
+
+  Expand(const Expand &) = delete;
+  Expand &operator=(const Expand &) = delete;
+
+  iterator begin() const noexcept { return iterator(this, begin_); }
+
+  iterator end() const noexcept { return iterator(this, end_); }
+
+  /** Why the last `@file` that couldn't be read was passed on as it is, if
+   * any has been.
+   */
+  const std::error_code &error() const noexcept { return error_; }
+};
+
+/** Arguments read straight from a single mapped response file, without an
+ * enclosing argument list.  Shell files are unquoted once, when they are
+ * mapped, so the range can be iterated any number of times.
+ */
+template <typename CharT, Format format> class File {
+public:
+  using iterator = std::conditional_t<
+      format == Format::nul, split::NulIterator<CharT>,
+      typename std::vector<std::basic_string_view<CharT>>::const_iterator>;
+
+private:
+  MappedFile file;
+
+  // Only for the shell format.
+  std::vector<std::basic_string_view<CharT>> args;
+
+public:
+  /** Map the file at path.  On failure, error is set and the range is empty.
+   */
+  File(const std::filesystem::path &path, std::error_code &error) noexcept
+      : file(path, error) {
+    if constexpr (format == Format::shell) {
+      try {
+        for (const auto arg :
+             split::Shell<CharT>(file.template chars<CharT>())) {
+          args.push_back(arg);
+        }
+      } catch (const std::bad_alloc &) {
+        error = std::make_error_code(std::errc::not_enough_memory);
+        args.clear();
+      }
+    }
+  }
+
+  iterator begin() const noexcept {
+    if constexpr (format == Format::nul) {
+      const auto contents = file.template chars<CharT>();
+      return iterator(
+          std::basic_string_view<CharT>(contents.data(), contents.size()));
+    } else {
+      return args.begin();
+    }
+  }
+
+  iterator end() const noexcept {
+    if constexpr (format == Format::nul) {
+      return iterator();
+    } else {
+      return args.end();
+    }
+  }
+};
+} // namespace response
+} // namespace args2
+
+namespace std {
+template <typename CharT, std::forward_iterator It,
+          args2::response::Format format>
+struct iterator_traits<args2::response::ExpandIterator<CharT, It, format>> {
+  using iterator_concept = std::forward_iterator_tag;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::basic_string_view<CharT>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = std::basic_string_view<CharT>;
+};
+} // namespace std
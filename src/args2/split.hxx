@@ -0,0 +1,279 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace args2 {
+namespace split {
+/** Splits a buffer into arguments separated by NUL characters, as written by
+ * `find -print0` or read by `xargs -0`.  Arguments are views straight into the
+ * buffer, which is never modified.  A trailing NUL does not start another
+ * argument.
+ * All end Iterators compare equal, even default-constructed ones.
+ */
+template <typename CharT> class NulIterator {
+private:
+  const CharT *position = nullptr;
+  const CharT *end = nullptr;
+  std::basic_string_view<CharT> value;
+  bool exhausted = true;
+
+  constexpr void next() noexcept {
+    if (position == end) {
+      value = std::basic_string_view<CharT>{};
+      exhausted = true;
+    } else {
+      const std::basic_string_view<CharT> rest(position, end);
+      const auto separator = rest.find(CharT{});
+      value = rest.substr(0, separator);
+      position = separator == rest.npos ? end : position + separator + 1;
+      exhausted = false;
+    }
+  }
+
+public:
+  constexpr NulIterator(const std::basic_string_view<CharT> buffer) noexcept
+      : position(buffer.data()), end(buffer.data() + buffer.size()) {
+    next();
+  }
+  constexpr NulIterator() noexcept {}
+
+  constexpr const std::basic_string_view<CharT> &operator*() const noexcept {
+    return value;
+  }
+
+  constexpr NulIterator &operator++() noexcept {
+    next();
+    return *this;
+  }
+  constexpr NulIterator operator++(int) noexcept {
+    auto prev = *this;
+    next();
+    return prev;
+  }
+
+  constexpr bool operator==(const NulIterator &other) const noexcept {
+    return exhausted == other.exhausted &&
+           (exhausted || value.data() == other.value.data());
+  }
+};
+
+/** Splits a buffer into arguments with the quoting rules of the POSIX shell.
+ * Arguments are separated by unquoted whitespace.  Single quotes preserve
+ * everything up to the closing quote, double quotes preserve everything but
+ * backslash escapes of `"`, `\`, `$`, and `` ` ``, and an unquoted backslash
+ * escapes any character.  A backslash before a newline joins the lines.  There
+ * are no expansions or comments, and an unclosed quote runs to the end of the
+ * buffer.
+ *
+ * Quotes and escapes are removed in place, so arguments are views straight
+ * into the buffer and nothing is copied.  Each argument is only ever written
+ * over its own raw text, and only when it contains quotes or escapes, so
+ * earlier arguments stay valid and unquoted text is never touched.
+ *
+ * Because the buffer is rewritten as it goes, this is a single-pass input
+ * iterator.
+ */
+template <typename CharT> class ShellIterator {
+private:
+  CharT *position = nullptr;
+  CharT *end = nullptr;
+  std::basic_string_view<CharT> value;
+  bool exhausted = true;
+
+  static constexpr bool whitespace(const CharT c) noexcept {
+    return c == CharT(' ') || c == CharT('\t') || c == CharT('\n') ||
+           c == CharT('\r') || c == CharT('\v') || c == CharT('\f');
+  }
+
+  constexpr void next() noexcept {
+    while (position != end && whitespace(*position)) {
+      ++position;
+    }
+    if (position == end) {
+      value = std::basic_string_view<CharT>{};
+      exhausted = true;
+      return;
+    }
+
+    CharT *const start = position;
+    CharT *output = position;
+    const auto put = [&](const CharT *const from) {
+      if (output != from) {
+        *output = *from;
+      }
+      ++output;
+    };
+
+    enum class Quote { none, single, double_ };
+    auto quote = Quote::none;
+
+    while (position != end) {
+      const auto c = *position;
+      const auto escaped = position + 1 != end ? position[1] : CharT{};
+      if (quote == Quote::single) {
+        if (c == CharT('\'')) {
+          quote = Quote::none;
+        } else {
+          put(position);
+        }
+        ++position;
+      } else if (c == CharT('\\') && position + 1 != end &&
+                 (quote == Quote::none || escaped == CharT('"') ||
+                  escaped == CharT('\\') || escaped == CharT('$') ||
+                  escaped == CharT('`') || escaped == CharT('\n'))) {
+        if (escaped != CharT('\n')) {
+          put(position + 1);
+        }
+        position += 2;
+      } else if (quote == Quote::double_) {
+        if (c == CharT('"')) {
+          quote = Quote::none;
+        } else {
+          put(position);
+        }
+        ++position;
+      } else if (whitespace(c)) {
+        break;
+      } else if (c == CharT('\'')) {
+        quote = Quote::single;
+        ++position;
+      } else if (c == CharT('"')) {
+        quote = Quote::double_;
+        ++position;
+      } else {
+        put(position);
+        ++position;
+      }
+    }
+
+    value = std::basic_string_view<CharT>(start, output);
+    exhausted = false;
+  }
+
+public:
+  constexpr ShellIterator(const std::span<CharT> buffer) noexcept
+      : position(buffer.data()), end(buffer.data() + buffer.size()) {
+    next();
+  }
+  constexpr ShellIterator() noexcept {}
+
+  constexpr const std::basic_string_view<CharT> &operator*() const noexcept {
+    return value;
+  }
+
+  constexpr ShellIterator &operator++() noexcept {
+    next();
+    return *this;
+  }
+  constexpr ShellIterator operator++(int) noexcept {
+    auto prev = *this;
+    next();
+    return prev;
+  }
+
+  constexpr bool operator==(const ShellIterator &other) const noexcept {
+    return exhausted == other.exhausted &&
+           (exhausted || value.data() == other.value.data());
+  }
+};
+
+/** A range of NUL-separated arguments.
+ */
+template <typename CharT> class Nul {
+public:
+  using iterator = NulIterator<CharT>;
+
+private:
+  std::basic_string_view<CharT> buffer;
+
+public:
+  constexpr Nul(const std::basic_string_view<CharT> buffer) noexcept
+      : buffer(buffer) {}
+
+  constexpr iterator begin() const noexcept { return iterator(buffer); }
+
+  constexpr iterator end() const noexcept { return iterator(); }
+};
+
+/** A range of shell-quoted arguments, unquoted in place.  Only iterate it
+ * once.
+ */
+template <typename CharT> class Shell {
+public:
+  using iterator = ShellIterator<CharT>;
+
+private:
+  std::span<CharT> buffer;
+
+public:
+  constexpr Shell(const std::span<CharT> buffer) noexcept : buffer(buffer) {}
+
+  constexpr iterator begin() const noexcept { return iterator(buffer); }
+
+  constexpr iterator end() const noexcept { return iterator(); }
+};
+
+/** Splits buffer after buffer into shell-quoted arguments, like Shell, for
+ * servers that receive command lines rather than argv.  The argument views
+ * are kept in storage that is reused from one buffer to the next, so once the
+ * tokenizer has seen its longest command line it never allocates again.
+ *
+ * The views point into the last buffer split, which is unquoted in place.
+ */
+template <typename CharT> class Tokenizer {
+public:
+  using arguments = std::span<const std::basic_string_view<CharT>>;
+  using iterator = typename arguments::iterator;
+
+private:
+  std::vector<std::basic_string_view<CharT>> args;
+
+public:
+  Tokenizer() noexcept = default;
+
+  /** Make room for capacity arguments up front.
+   */
+  explicit Tokenizer(const std::size_t capacity) { args.reserve(capacity); }
+
+  /** Split buffer, replacing the arguments of the last one.
+   */
+  arguments split(const std::span<CharT> buffer) {
+    args.clear();
+    for (ShellIterator<CharT> it(buffer), end; it != end; ++it) {
+      args.push_back(*it);
+    }
+    return args;
+  }
+
+  /** The arguments of the last buffer split.
+   */
+  arguments get() const noexcept { return args; }
+};
+} // namespace split
+} // namespace args2
+
+namespace std {
+template <typename CharT>
+struct iterator_traits<args2::split::NulIterator<CharT>> {
+  using iterator_concept = std::forward_iterator_tag;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::basic_string_view<CharT>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const std::basic_string_view<CharT> *;
+  using reference = const std::basic_string_view<CharT> &;
+};
+
+template <typename CharT>
+struct iterator_traits<args2::split::ShellIterator<CharT>> {
+  using iterator_concept = std::input_iterator_tag;
+  using iterator_category = std::input_iterator_tag;
+  using value_type = std::basic_string_view<CharT>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const std::basic_string_view<CharT> *;
+  using reference = const std::basic_string_view<CharT> &;
+};
+} // namespace std
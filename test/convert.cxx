@@ -0,0 +1,175 @@
+#include <args2/convert.hxx>
+#include <args2/parser.hxx>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using namespace std::literals::string_view_literals;
+using namespace std::literals::chrono_literals;
+
+using args2::convert::Parsed;
+using args2::convert::Size;
+using args2::parser::InvalidValue;
+
+TEST_CASE("Numbers convert with from_chars", "[convert]") {
+  using args2::convert::parse;
+
+  REQUIRE(parse<int>("-42"sv) == Parsed<int>(-42));
+  REQUIRE(parse<unsigned char>("255"sv) ==
+          Parsed<unsigned char>(std::uint8_t{255}));
+  REQUIRE(parse<unsigned char>("256"sv) ==
+          Parsed<unsigned char>(InvalidValue::out_of_range));
+  REQUIRE(parse<int>(""sv) == Parsed<int>(InvalidValue::malformed));
+  REQUIRE(parse<int>("12a"sv) == Parsed<int>(InvalidValue::malformed));
+  REQUIRE(parse<int>(" 12"sv) == Parsed<int>(InvalidValue::malformed));
+  REQUIRE(parse<double>("1.5e3"sv) == Parsed<double>(1500.0));
+  REQUIRE(parse<double>("1.5.3"sv) == Parsed<double>(InvalidValue::malformed));
+
+  REQUIRE(parse<long>(U"-1234567"sv) == Parsed<long>(-1234567));
+  REQUIRE(parse<float>(L"0.25"sv) == Parsed<float>(0.25f));
+  REQUIRE(parse<int>(U"１２"sv) == Parsed<int>(InvalidValue::malformed));
+  REQUIRE(parse<std::uint64_t>(u8"18446744073709551615"sv) ==
+          Parsed<std::uint64_t>(18446744073709551615u));
+
+  // Wide values are narrowed on the stack, which bounds their length.
+  const std::u32string padded(256, U'0');
+  REQUIRE(parse<int>(std::u32string_view(padded)) == Parsed<int>(0));
+  REQUIRE(parse<int>(std::u32string_view(padded + U"7")) ==
+          Parsed<int>(InvalidValue::malformed));
+  REQUIRE(parse<int>(std::string_view("0" + std::string(256, '0') + "7")) ==
+          Parsed<int>(7));
+}
+
+TEST_CASE("Sizes convert with units", "[convert]") {
+  using args2::convert::parse;
+
+  REQUIRE(parse<Size>("512"sv) == Parsed<Size>(Size{512}));
+  REQUIRE(parse<Size>("512B"sv) == Parsed<Size>(Size{512}));
+  REQUIRE(parse<Size>("4K"sv) == Parsed<Size>(Size{4096}));
+  REQUIRE(parse<Size>("4k"sv) == Parsed<Size>(Size{4096}));
+  REQUIRE(parse<Size>("2GiB"sv) == Parsed<Size>(Size{2ull << 30}));
+  REQUIRE(parse<Size>("10MB"sv) == Parsed<Size>(Size{10'000'000}));
+  REQUIRE(parse<Size>(U"3T"sv) == Parsed<Size>(Size{3ull << 40}));
+  REQUIRE(parse<Size>("15E"sv) == Parsed<Size>(Size{15ull << 60}));
+  REQUIRE(parse<Size>("16E"sv) == Parsed<Size>(InvalidValue::out_of_range));
+  REQUIRE(parse<Size>("4Q"sv) == Parsed<Size>(InvalidValue::malformed));
+  REQUIRE(parse<Size>("4KiBs"sv) == Parsed<Size>(InvalidValue::malformed));
+  REQUIRE(parse<Size>("K"sv) == Parsed<Size>(InvalidValue::malformed));
+  REQUIRE(parse<Size>("-4K"sv) == Parsed<Size>(InvalidValue::malformed));
+}
+
+TEST_CASE("Durations convert with units", "[convert]") {
+  using args2::convert::parse;
+  using std::chrono::milliseconds;
+  using std::chrono::seconds;
+
+  REQUIRE(parse<milliseconds>("250ms"sv) == Parsed<milliseconds>(250ms));
+  REQUIRE(parse<milliseconds>("2s"sv) == Parsed<milliseconds>(2000ms));
+  REQUIRE(parse<seconds>("3h"sv) == Parsed<seconds>(10800s));
+  REQUIRE(parse<seconds>("1d"sv) == Parsed<seconds>(86400s));
+  REQUIRE(parse<std::chrono::nanoseconds>(U"7us"sv) ==
+          Parsed<std::chrono::nanoseconds>(7000ns));
+  REQUIRE(parse<seconds>("5"sv) == Parsed<seconds>(InvalidValue::malformed));
+  REQUIRE(parse<seconds>("5y"sv) == Parsed<seconds>(InvalidValue::malformed));
+  REQUIRE(parse<seconds>("200000d"sv) ==
+          Parsed<seconds>(InvalidValue::out_of_range));
+
+  // T must hold the duration exactly.
+  using Narrow = std::chrono::duration<std::int32_t, std::nano>;
+  REQUIRE(parse<Narrow>("2s"sv) == Parsed<Narrow>(Narrow(2'000'000'000)));
+  REQUIRE(parse<Narrow>("3s"sv) == Parsed<Narrow>(InvalidValue::out_of_range));
+  using Picoseconds = std::chrono::duration<std::int64_t, std::pico>;
+  REQUIRE(parse<Picoseconds>("9000000000000000ns"sv) ==
+          Parsed<Picoseconds>(Picoseconds(9'000'000'000'000'000'000)));
+  REQUIRE(parse<Picoseconds>("9300000000000000ns"sv) ==
+          Parsed<Picoseconds>(InvalidValue::out_of_range));
+  REQUIRE(parse<seconds>("1ms"sv) ==
+          Parsed<seconds>(InvalidValue::out_of_range));
+  REQUIRE(parse<seconds>("3000ms"sv) == Parsed<seconds>(3s));
+  using Fractional = std::chrono::duration<double>;
+  REQUIRE(parse<Fractional>("1ms"sv) == Parsed<Fractional>(Fractional(0.001)));
+}
+
+TEST_CASE("Names convert by lookup", "[convert]") {
+  using args2::convert::parse;
+
+  enum class Color { red, green, blue };
+  constexpr std::array<std::pair<std::string_view, Color>, 3> colors{{
+      {"red", Color::red},
+      {"green", Color::green},
+      {"blue", Color::blue},
+  }};
+
+  REQUIRE(parse<Color>("green"sv, colors) == Parsed<Color>(Color::green));
+  REQUIRE(parse<Color>("Green"sv, colors) ==
+          Parsed<Color>(InvalidValue::malformed));
+}
+
+TEST_CASE("Lists convert into a caller buffer", "[convert]") {
+  using args2::convert::parse_list;
+
+  std::array<int, 4> buffer{};
+  const auto ints = [&](const auto text) {
+    const auto result = parse_list(text, std::span<int>(buffer));
+    if (const auto error = std::get_if<InvalidValue>(&result)) {
+      return std::variant<std::vector<int>, InvalidValue>(*error);
+    }
+    const auto values = std::get<std::span<int>>(result);
+    return std::variant<std::vector<int>, InvalidValue>(
+        std::vector<int>(values.begin(), values.end()));
+  };
+  using List = std::variant<std::vector<int>, InvalidValue>;
+
+  REQUIRE(ints(""sv) == List(std::vector<int>{}));
+  REQUIRE(ints("7"sv) == List(std::vector<int>{7}));
+  REQUIRE(ints("1,-2,3,4"sv) == List(std::vector<int>{1, -2, 3, 4}));
+  REQUIRE(ints("1,2,3,4,5"sv) == List(InvalidValue::too_many));
+  REQUIRE(ints("1,,3"sv) == List(InvalidValue::malformed));
+  REQUIRE(ints("1,2,"sv) == List(InvalidValue::malformed));
+  REQUIRE(ints("1;2"sv) == List(InvalidValue::malformed));
+  REQUIRE(ints("1,99999999999"sv) == List(InvalidValue::out_of_range));
+
+  REQUIRE(ints(U"1,-2,3,4"sv) == List(std::vector<int>{1, -2, 3, 4}));
+  REQUIRE(ints(U"1,2,3,4,5"sv) == List(InvalidValue::too_many));
+  REQUIRE(ints(U"1,,3"sv) == List(InvalidValue::malformed));
+
+  std::array<Size, 2> sizes{};
+  const auto result = parse_list("4K,1MB"sv, std::span<Size>(sizes));
+  REQUIRE(std::get<std::span<Size>>(result).size() == 2);
+  REQUIRE(sizes == std::array<Size, 2>{Size{4096}, Size{1'000'000}});
+}
+
+TEST_CASE("Flag values convert to flag errors", "[convert]") {
+  using args2::parser::Error;
+  using args2::parser::InvalidValueError;
+  using args2::parser::LongValueFlag;
+  using args2::parser::ShortValueFlag;
+
+  const LongValueFlag<char> timeout{"timeout", "250ms"};
+  REQUIRE(args2::convert::value<std::chrono::milliseconds>(timeout) ==
+          std::variant<std::chrono::milliseconds, Error<char>>(250ms));
+
+  const ShortValueFlag<char> jobs{'j', "many"};
+  REQUIRE(args2::convert::value<unsigned>(jobs) ==
+          std::variant<unsigned, Error<char>>(Error<char>(
+              InvalidValueError<char>{jobs, InvalidValue::malformed})));
+
+  std::array<unsigned, 2> ports{};
+  const LongValueFlag<char> listen{"ports", "80,443,8080"};
+  const auto error = args2::convert::list(listen, std::span<unsigned>(ports));
+  REQUIRE(std::get<Error<char>>(error) ==
+          Error<char>(InvalidValueError<char>{listen, InvalidValue::too_many}));
+
+  const LongValueFlag<char32_t> sizes{U"sizes", U"1K,2K"};
+  std::array<Size, 2> buffer{};
+  const auto result = args2::convert::list(sizes, std::span<Size>(buffer));
+  REQUIRE(std::get<std::span<Size>>(result).size() == 2);
+  REQUIRE(buffer == std::array<Size, 2>{Size{1024}, Size{2048}});
+}
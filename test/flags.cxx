@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <args2/flags.hxx>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals::string_view_literals;
+
+namespace {
+constexpr args2::parser::Schema<char, 4, 4>
+    schema({'a', 'b'}, {'c', 'd'}, {"alpha", "beta"}, {"gamma", "delta"});
+
+constexpr args2::parser::Schema<char32_t, 3, 2>
+    wide_schema({U'a', U'é'}, {U'☃'}, {U"alpha"}, {U"snowman"});
+} // namespace
+
+using args2::parser::FlagKind;
+
+static_assert(schema.short_kind('a') == FlagKind::flag);
+static_assert(schema.short_kind('d') == FlagKind::value_flag);
+static_assert(schema.short_kind('x') == FlagKind::unknown);
+static_assert(schema.long_kind("delta"sv) == FlagKind::value_flag);
+static_assert(schema.long_kind("delt"sv) == FlagKind::unknown);
+static_assert(schema.long_kind("omega"sv) == FlagKind::unknown);
+static_assert(schema.long_kind("alphabet"sv) == FlagKind::unknown);
+static_assert(schema.long_kind(""sv) == FlagKind::unknown);
+static_assert(schema.long_kind("epsilon"sv) == FlagKind::unknown);
+static_assert(wide_schema.short_kind(U'€') == FlagKind::unknown);
+static_assert(wide_schema.long_kind(U"snow"sv) == FlagKind::unknown);
+static_assert(wide_schema.long_kind(U"omega"sv) == FlagKind::unknown);
+
+TEST_CASE("Schema classifies short flags", "[schema]") {
+  REQUIRE(schema.short_kind('a') == FlagKind::flag);
+  REQUIRE(schema.short_kind('b') == FlagKind::flag);
+  REQUIRE(schema.short_kind('c') == FlagKind::value_flag);
+  REQUIRE(schema.short_kind('d') == FlagKind::value_flag);
+  for (int c = -128; c < 128; ++c) {
+    if (c < 'a' || c > 'd') {
+      REQUIRE(schema.short_kind(static_cast<char>(c)) == FlagKind::unknown);
+    }
+  }
+
+  REQUIRE(wide_schema.short_kind(U'a') == FlagKind::flag);
+  REQUIRE(wide_schema.short_kind(U'é') == FlagKind::flag);
+  REQUIRE(wide_schema.short_kind(U'☃') == FlagKind::value_flag);
+  REQUIRE(wide_schema.short_kind(U'b') == FlagKind::unknown);
+}
+
+TEST_CASE("Schema classifies long flags", "[schema]") {
+  REQUIRE(schema.long_kind("alpha") == FlagKind::flag);
+  REQUIRE(schema.long_kind("beta") == FlagKind::flag);
+  REQUIRE(schema.long_kind("gamma") == FlagKind::value_flag);
+  REQUIRE(schema.long_kind("delta") == FlagKind::value_flag);
+  REQUIRE(schema.long_kind("") == FlagKind::unknown);
+  REQUIRE(schema.long_kind("alphabet") == FlagKind::unknown);
+
+  REQUIRE(wide_schema.long_kind(U"alpha") == FlagKind::flag);
+  REQUIRE(wide_schema.long_kind(U"snowman") == FlagKind::value_flag);
+  REQUIRE(wide_schema.long_kind(U"snow") == FlagKind::unknown);
+}
+
+TEST_CASE("FlagTable classifies flags", "[flagtable]") {
+  const args2::parser::FlagTable<char> table(
+      {'a', 'b'}, {'c', 'd', 'a'}, {"alpha", "beta"}, {"gamma", "delta"});
+
+  REQUIRE(table.short_kind('a') == FlagKind::flag);
+  REQUIRE(table.short_kind('b') == FlagKind::flag);
+  REQUIRE(table.short_kind('c') == FlagKind::value_flag);
+  REQUIRE(table.short_kind('d') == FlagKind::value_flag);
+  REQUIRE(table.short_kind('\xff') == FlagKind::unknown);
+  REQUIRE(table.long_kind("alpha") == FlagKind::flag);
+  REQUIRE(table.long_kind("delta") == FlagKind::value_flag);
+  REQUIRE(table.long_kind("alph") == FlagKind::unknown);
+  REQUIRE(table.long_kind("zeta") == FlagKind::unknown);
+}
+
+TEST_CASE("FlagTable classifies wide flags", "[flagtable]") {
+  const std::vector<char32_t> short_flags{U'a', U'é', U'€'};
+  const std::vector<std::u32string_view> long_flags{U"snowman", U"alpha"};
+  const args2::parser::FlagTable<char32_t> table(
+      short_flags, std::u32string_view(U"☃b"), long_flags,
+      std::vector<std::u32string_view>{U"beta", U"alpha"});
+
+  REQUIRE(table.short_kind(U'a') == FlagKind::flag);
+  REQUIRE(table.short_kind(U'é') == FlagKind::flag);
+  REQUIRE(table.short_kind(U'€') == FlagKind::flag);
+  REQUIRE(table.short_kind(U'☃') == FlagKind::value_flag);
+  REQUIRE(table.short_kind(U'b') == FlagKind::value_flag);
+  REQUIRE(table.short_kind(U'ü') == FlagKind::unknown);
+  REQUIRE(table.long_kind(U"alpha") == FlagKind::flag);
+  REQUIRE(table.long_kind(U"snowman") == FlagKind::flag);
+  REQUIRE(table.long_kind(U"beta") == FlagKind::value_flag);
+  REQUIRE(table.long_kind(U"gamma") == FlagKind::unknown);
+}
+
+TEST_CASE("FlagTable exact lookups agree with a linear scan", "[flagtable]") {
+  std::mt19937 random(4321);
+  std::uniform_int_distribution<int> letter('a', 'c');
+  std::uniform_int_distribution<std::size_t> length(0, 6);
+  const auto word = [&] {
+    std::string word(length(random), 'a');
+    std::ranges::generate(word,
+                          [&] { return static_cast<char>(letter(random)); });
+    return word;
+  };
+
+  std::vector<std::string> storage(300);
+  std::ranges::generate(storage, word);
+  const std::vector<std::string_view> names(storage.begin(), storage.end());
+  const auto plain = std::span(names).first(150);
+  const auto valued = std::span(names).subspan(150);
+  const args2::parser::FlagTable<char> table({}, {}, plain, valued);
+
+  // Wide keys hold fewer characters, so they collide more.
+  std::vector<std::u32string> wide_storage;
+  for (const auto &name : storage) {
+    wide_storage.emplace_back(name.begin(), name.end());
+  }
+  const std::vector<std::u32string_view> wide_names(wide_storage.begin(),
+                                                    wide_storage.end());
+  const args2::parser::FlagTable<char32_t> wide_table(
+      {}, {}, std::span(wide_names).first(150),
+      std::span(wide_names).subspan(150));
+
+  for (int i = 0; i < 2000; ++i) {
+    const auto flag = word();
+    auto expected = FlagKind::unknown;
+    if (std::ranges::find(plain, flag) != plain.end()) {
+      expected = FlagKind::flag;
+    } else if (std::ranges::find(valued, flag) != valued.end()) {
+      expected = FlagKind::value_flag;
+    }
+    REQUIRE(table.long_kind(flag) == expected);
+    REQUIRE(wide_table.long_kind(std::u32string(flag.begin(), flag.end())) ==
+            expected);
+  }
+  REQUIRE(table.long_kind(std::string(20, 'a')) == FlagKind::unknown);
+  REQUIRE(args2::parser::FlagTable<char>().long_kind("") == FlagKind::unknown);
+}
+
+TEST_CASE("FlagTable matches abbreviations", "[flagtable]") {
+  using args2::parser::LongMatching;
+
+  const std::vector<std::string_view> long_flags{"verbose", "verb", "version",
+                                                 "color"};
+  const args2::parser::FlagTable<char> table(
+      {}, {}, long_flags, std::vector<std::string_view>{"columns", "output"},
+      LongMatching::abbreviations);
+
+  const auto require_match = [&](const std::string_view flag,
+                                 const FlagKind kind,
+                                 const std::string_view full) {
+    const auto match = table.long_match(flag);
+    REQUIRE(match.kind == kind);
+    REQUIRE(match.flag == full);
+    REQUIRE(match.candidates.empty());
+  };
+  require_match("verbose", FlagKind::flag, "verbose");
+  require_match("verbo", FlagKind::flag, "verbose");
+  require_match("verb", FlagKind::flag, "verb");
+  require_match("vers", FlagKind::flag, "version");
+  require_match("o", FlagKind::value_flag, "output");
+  require_match("colu", FlagKind::value_flag, "columns");
+  require_match("verbosely", FlagKind::unknown, "verbosely");
+  require_match("x", FlagKind::unknown, "x");
+
+  // Exact lookups stay exact.
+  REQUIRE(table.long_kind("verbo") == FlagKind::unknown);
+
+  const auto ambiguous = table.long_match("ver");
+  REQUIRE(ambiguous.kind == FlagKind::unknown);
+  REQUIRE(ambiguous.flag == "ver");
+  REQUIRE(std::ranges::equal(
+      ambiguous.candidates,
+      std::vector<std::string_view>{"verb", "verbose", "version"}));
+  REQUIRE(table.long_match("").candidates.size() == 6);
+
+  const args2::parser::FlagTable<char> exact({}, {}, long_flags, {});
+  REQUIRE(exact.long_match("verbo").kind == FlagKind::unknown);
+  REQUIRE(exact.long_match("verb").kind == FlagKind::flag);
+  REQUIRE(exact.long_match("ver").candidates.empty());
+}
+
+TEST_CASE("FlagTable abbreviations agree with a linear scan", "[flagtable]") {
+  std::mt19937 random(1234);
+  std::uniform_int_distribution<int> letter('a', 'd');
+  std::uniform_int_distribution<std::size_t> length(0, 8);
+  const auto word = [&] {
+    std::string word(length(random), 'a');
+    std::ranges::generate(word,
+                          [&] { return static_cast<char>(letter(random)); });
+    return word;
+  };
+
+  std::vector<std::string> storage(800);
+  std::ranges::generate(storage, word);
+  const std::vector<std::string_view> names(storage.begin(), storage.end());
+  const args2::parser::FlagTable<char> table(
+      {}, {}, std::span(names).first(400), std::span(names).subspan(400),
+      args2::parser::LongMatching::abbreviations);
+
+  std::vector<std::string_view> sorted = names;
+  std::ranges::sort(sorted);
+  sorted.erase(std::ranges::unique(sorted).begin(), sorted.end());
+
+  for (int i = 0; i < 2000; ++i) {
+    const auto flag = word();
+    std::vector<std::string_view> prefixed;
+    for (const auto name : sorted) {
+      if (name.starts_with(flag)) {
+        prefixed.push_back(name);
+      }
+    }
+
+    const auto match = table.long_match(flag);
+    if (std::ranges::find(sorted, flag) != sorted.end()) {
+      REQUIRE(match.kind == table.long_kind(flag));
+      REQUIRE(match.flag == flag);
+      REQUIRE(match.candidates.empty());
+    } else if (prefixed.size() == 1) {
+      REQUIRE(match.kind == table.long_kind(prefixed.front()));
+      REQUIRE(match.flag == prefixed.front());
+    } else {
+      REQUIRE(match.kind == FlagKind::unknown);
+      REQUIRE(std::ranges::equal(match.candidates, prefixed));
+    }
+  }
+}
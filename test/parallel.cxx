@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <args2/argv.hxx>
+#include <args2/parallel.hxx>
+#include <args2/parser.hxx>
+#include <catch2/catch_test_macros.hpp>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+const std::vector<std::string> pieces{
+    "-a",       "-ab",     "-abc",        "-cepsilon", "-bd",    "-d",
+    "--alpha",  "--beta",  "--gamma=eta", "--gamma=",  "--gamma", "--delta",
+    "zeta",     "-",       "",            "--",        "-x",     "-abx",
+    "--alpha=", "--omega", "--=",         "-ac",       "--al",   "--alphab",
+    "--gam",    "--be=x",  "--d",
+};
+
+template <typename Parser>
+void require_same_results(const Parser &parser, const unsigned threads) {
+  std::vector<args2::parser::Result<char>> expected;
+  std::ranges::copy(parser, std::back_inserter(expected));
+
+  std::vector<args2::parser::Result<char>> results;
+  args2::parallel::parse(parser, std::back_inserter(results), threads);
+  REQUIRE(results == expected);
+}
+} // namespace
+
+TEST_CASE("Parallel parse matches the serial parser", "[parallel]") {
+  std::mt19937 random(1234);
+  std::uniform_int_distribution<std::size_t> piece(0, pieces.size() - 1);
+  std::uniform_int_distribution<std::size_t> length(0, 12);
+
+  for (int i = 0; i < 2000; ++i) {
+    std::vector<std::string> args(length(random));
+    std::ranges::generate(args, [&] { return pieces[piece(random)]; });
+
+    using Parser = args2::parser::Parser<char, decltype(args.cbegin())>;
+    const Parser parser(args, {'a', 'b'}, {'c', 'd'}, {"alpha", "beta"},
+                        {"gamma", "delta"});
+    require_same_results(parser, 4);
+  }
+}
+
+TEST_CASE("Parallel parse matches abbreviations like the serial parser",
+          "[parallel]") {
+  std::mt19937 random(4321);
+  std::uniform_int_distribution<std::size_t> piece(0, pieces.size() - 1);
+  std::uniform_int_distribution<std::size_t> length(0, 12);
+  const args2::parser::FlagTable<char> table(
+      {'a', 'b'}, {'c', 'd'}, {"alpha", "beta"}, {"gamma", "delta", "alphabet"},
+      args2::parser::LongMatching::abbreviations);
+
+  for (int i = 0; i < 2000; ++i) {
+    std::vector<std::string> args(length(random));
+    std::ranges::generate(args, [&] { return pieces[piece(random)]; });
+    require_same_results(args2::parser::Parser(args, table), 4);
+  }
+}
+
+TEST_CASE("Parallel parse splits large inputs over threads", "[parallel]") {
+  std::mt19937 random(5678);
+  std::uniform_int_distribution<std::size_t> piece(0, 11);
+
+  std::vector<std::string> args(200000);
+  std::ranges::generate(args, [&] { return pieces[piece(random)]; });
+  args[150000] = "--";
+
+  using Parser = args2::parser::Parser<char, decltype(args.cbegin())>;
+  const Parser parser(args, {'a', 'b'}, {'c', 'd'}, {"alpha", "beta"},
+                      {"gamma", "delta"});
+  require_same_results(parser, 8);
+}
+
+TEST_CASE("Parallel parse works over argv", "[parallel]") {
+  static_assert(std::random_access_iterator<args2::argv::Iterator<char>>);
+
+  const char *argv[] = {"-abcepsilon", "--gamma", "eta", "zeta", "-d",
+                        nullptr};
+  const args2::argv::Argv<char> args(5, argv);
+
+  using Parser = args2::parser::Parser<char, args2::argv::Iterator<char>>;
+  const Parser parser(args, {'a', 'b'}, {'c', 'd'}, {"alpha", "beta"},
+                      {"gamma", "delta"});
+  require_same_results(parser, 2);
+}
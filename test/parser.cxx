@@ -1,9 +1,13 @@
 #include <algorithm>
 #include <args2/parser.hxx>
+#include <args2/split.hxx>
+#include <array>
 #include <bits/ranges_algobase.h>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
 #include <iterator>
 #include <ranges>
+#include <string>
 #include <vector>
 
 TEST_CASE("Parser can iterate short flags", "[shortflags]") {
@@ -36,7 +40,8 @@ TEST_CASE("Parser fails on unknown short flag", "[shortflags]") {
   using Iterator = Parser::iterator;
 
   std::vector<std::iterator_traits<Iterator>::value_type> collection;
-  std::copy(parser.begin(), parser.end(), std::back_inserter(collection));
+  std::ranges::copy(parser.begin(), parser.end(),
+                    std::back_inserter(collection));
   REQUIRE(collection ==
           std::vector<std::iterator_traits<Iterator>::value_type>{
               args2::parser::Result<char>(args2::parser::ShortFlag<char>('a')),
@@ -56,7 +61,8 @@ TEST_CASE("Parser fails short flag needing value but getting none",
   using Iterator = Parser::iterator;
 
   std::vector<std::iterator_traits<Iterator>::value_type> collection;
-  std::copy(parser.begin(), parser.end(), std::back_inserter(collection));
+  std::ranges::copy(parser.begin(), parser.end(),
+                    std::back_inserter(collection));
   REQUIRE(
       collection ==
       std::vector<std::iterator_traits<Iterator>::value_type>{
@@ -75,7 +81,8 @@ TEST_CASE("Parser can get values from shortflags", "[shortflags]") {
   using Iterator = Parser::iterator;
 
   std::vector<std::iterator_traits<Iterator>::value_type> collection;
-  std::copy(parser.begin(), parser.end(), std::back_inserter(collection));
+  std::ranges::copy(parser.begin(), parser.end(),
+                    std::back_inserter(collection));
   REQUIRE(collection ==
           std::vector<std::iterator_traits<Iterator>::value_type>{
               args2::parser::Result<char>(args2::parser::ShortFlag<char>('a')),
@@ -96,7 +103,8 @@ TEST_CASE("Parser can parse long flags", "[longflags]") {
   using Iterator = Parser::iterator;
 
   std::vector<std::iterator_traits<Iterator>::value_type> collection;
-  std::copy(parser.begin(), parser.end(), std::back_inserter(collection));
+  std::ranges::copy(parser.begin(), parser.end(),
+                    std::back_inserter(collection));
   REQUIRE(
       collection ==
       std::vector<std::iterator_traits<Iterator>::value_type>{
@@ -115,7 +123,8 @@ TEST_CASE("Parser can parse values from long flags", "[longflags]") {
   using Iterator = Parser::iterator;
 
   std::vector<std::iterator_traits<Iterator>::value_type> collection;
-  std::copy(parser.begin(), parser.end(), std::back_inserter(collection));
+  std::ranges::copy(parser.begin(), parser.end(),
+                    std::back_inserter(collection));
   REQUIRE(
       collection ==
       std::vector<std::iterator_traits<Iterator>::value_type>{
@@ -136,7 +145,8 @@ TEST_CASE("Parser fails on unknown long flag", "[longflags]") {
   using Iterator = Parser::iterator;
 
   std::vector<std::iterator_traits<Iterator>::value_type> collection;
-  std::copy(parser.begin(), parser.end(), std::back_inserter(collection));
+  std::ranges::copy(parser.begin(), parser.end(),
+                    std::back_inserter(collection));
   REQUIRE(
       collection ==
       std::vector<std::iterator_traits<Iterator>::value_type>{
@@ -156,7 +166,8 @@ TEST_CASE("Parser fails when an unexpected value is present", "[longflags]") {
   using Iterator = Parser::iterator;
 
   std::vector<std::iterator_traits<Iterator>::value_type> collection;
-  std::copy(parser.begin(), parser.end(), std::back_inserter(collection));
+  std::ranges::copy(parser.begin(), parser.end(),
+                    std::back_inserter(collection));
   REQUIRE(
       collection ==
       std::vector<std::iterator_traits<Iterator>::value_type>{
@@ -175,7 +186,8 @@ TEST_CASE("Parser fails on missing value", "[longflags]") {
   using Iterator = Parser::iterator;
 
   std::vector<std::iterator_traits<Iterator>::value_type> collection;
-  std::copy(parser.begin(), parser.end(), std::back_inserter(collection));
+  std::ranges::copy(parser.begin(), parser.end(),
+                    std::back_inserter(collection));
   REQUIRE(
       collection ==
       std::vector<std::iterator_traits<Iterator>::value_type>{
@@ -215,3 +227,328 @@ TEST_CASE("Parser can iterate all types in all orders", "[alltypes]") {
           args2::parser::Result<char>(args2::parser::Positional<char>("iota")),
       });
 }
+
+namespace {
+constexpr args2::parser::Schema<char, 4, 4>
+    schema({'a', 'b'}, {'c', 'd'}, {"alpha", "beta"}, {"gamma", "delta"});
+
+constexpr bool parses_at_compile_time() {
+  constexpr std::array<std::string_view, 4> args{"-acepsilon", "--alpha",
+                                                 "--gamma=eta", "iota"};
+  using Parser = args2::parser::Parser<char, decltype(args.begin()),
+                                       args2::parser::StaticSchema<schema>>;
+  Parser parser(args);
+  auto it = parser.begin();
+  return *it++ == args2::parser::Result<char>(
+                      args2::parser::ShortFlag<char>('a')) &&
+         *it++ == args2::parser::Result<char>(
+                      args2::parser::ShortValueFlag<char>('c', "epsilon")) &&
+         *it++ == args2::parser::Result<char>(
+                      args2::parser::LongFlag<char>("alpha")) &&
+         *it++ == args2::parser::Result<char>(
+                      args2::parser::LongValueFlag<char>("gamma", "eta")) &&
+         *it++ == args2::parser::Result<char>(
+                      args2::parser::Positional<char>("iota")) &&
+         it == parser.end();
+}
+
+constexpr bool stops_at_compile_time() {
+  constexpr std::array<std::string_view, 2> args{"--alpha", "--omega"};
+  using Parser = args2::parser::Parser<char, decltype(args.begin()),
+                                       args2::parser::StaticSchema<schema>>;
+  Parser parser(args);
+  auto it = parser.begin();
+  return *it++ == args2::parser::Result<char>(
+                      args2::parser::LongFlag<char>("alpha")) &&
+         *it++ == args2::parser::Result<char>(
+                      args2::parser::UnknownFlagError<char>(
+                          args2::parser::LongFlag<char>("omega"))) &&
+         it == parser.end();
+}
+} // namespace
+
+static_assert(parses_at_compile_time());
+static_assert(stops_at_compile_time());
+
+TEST_CASE("Parser can use a compile-time schema", "[schema]") {
+  const std::vector<std::string> args{"-acepsilon",  "--alpha", "zeta",
+                                      "--gamma=eta", "-d",      "-btheta",
+                                      "--delta",     "-abcd",   "--epsilon"};
+  using Parser = args2::parser::Parser<char, decltype(args.begin()),
+                                       args2::parser::StaticSchema<schema>>;
+
+  Parser parser(args);
+
+  using Iterator = Parser::iterator;
+
+  std::vector<std::iterator_traits<Iterator>::value_type> collection;
+  std::ranges::copy(parser, std::back_inserter(collection));
+  REQUIRE(
+      collection ==
+      std::vector<std::iterator_traits<Iterator>::value_type>{
+          args2::parser::Result<char>(args2::parser::ShortFlag<char>('a')),
+          args2::parser::Result<char>(
+              args2::parser::ShortValueFlag<char>('c', "epsilon")),
+          args2::parser::Result<char>(args2::parser::LongFlag<char>("alpha")),
+          args2::parser::Result<char>(args2::parser::Positional<char>("zeta")),
+          args2::parser::Result<char>(
+              args2::parser::LongValueFlag<char>("gamma", "eta")),
+          args2::parser::Result<char>(
+              args2::parser::ShortValueFlag<char>('d', "-btheta")),
+          args2::parser::Result<char>(
+              args2::parser::LongValueFlag<char>("delta", "-abcd")),
+          args2::parser::Result<char>(args2::parser::UnknownFlagError<char>(
+              args2::parser::LongFlag<char>("epsilon"))),
+      });
+}
+
+TEST_CASE("Parser can refer to a shared flag table", "[flagtable]") {
+  const std::vector<std::string> args{"-abc", "--gamma", "eta", "--beta"};
+  const args2::parser::FlagTable<char> table({'a', 'b'}, {'c', 'd'},
+                                             {"alpha", "beta"},
+                                             {"gamma", "delta"});
+
+  args2::parser::Parser parser(args, table);
+  using Flags = args2::parser::FlagsRef<args2::parser::FlagTable<char>>;
+  static_assert(std::is_same_v<
+                decltype(parser),
+                args2::parser::Parser<char, decltype(args.begin()), Flags>>);
+
+  using Iterator = decltype(parser)::iterator;
+
+  std::vector<std::iterator_traits<Iterator>::value_type> collection;
+  std::ranges::copy(parser, std::back_inserter(collection));
+  REQUIRE(
+      collection ==
+      std::vector<std::iterator_traits<Iterator>::value_type>{
+          args2::parser::Result<char>(args2::parser::ShortFlag<char>('a')),
+          args2::parser::Result<char>(args2::parser::ShortFlag<char>('b')),
+          args2::parser::Result<char>(
+              args2::parser::ShortValueFlag<char>('c', "--gamma")),
+          args2::parser::Result<char>(args2::parser::Positional<char>("eta")),
+          args2::parser::Result<char>(args2::parser::LongFlag<char>("beta")),
+      });
+}
+
+TEST_CASE("Parser composes with range adaptors", "[view]") {
+  const std::vector<std::string> args{"-ab", "one", "--gamma=two", "three"};
+  using Parser = args2::parser::Parser<char, decltype(args.begin()),
+                                       args2::parser::StaticSchema<schema>>;
+  using SetParser = args2::parser::Parser<char, decltype(args.begin())>;
+
+  static_assert(std::ranges::view<Parser>);
+  static_assert(std::ranges::forward_range<Parser>);
+  static_assert(std::ranges::borrowed_range<Parser>);
+  static_assert(!std::ranges::view<SetParser>);
+  static_assert(!std::ranges::borrowed_range<SetParser>);
+
+  // Single-pass arguments make a single-pass parser.
+  using ShellParser =
+      args2::parser::Parser<char, args2::split::ShellIterator<char>>;
+  static_assert(std::ranges::input_range<ShellParser>);
+  static_assert(!std::ranges::forward_range<ShellParser>);
+
+  auto positionals =
+      Parser(args) | std::views::filter([](const auto &result) {
+        const auto token = std::get_if<args2::parser::Token<char>>(&result);
+        return token && std::holds_alternative<args2::parser::Positional<char>>(
+                            *token);
+      }) |
+      std::views::transform([](const auto &result) {
+        return std::get<args2::parser::Positional<char>>(
+                   std::get<args2::parser::Token<char>>(result))
+            .value;
+      });
+
+  std::vector<std::string_view> collection;
+  std::ranges::copy(positionals, std::back_inserter(collection));
+  REQUIRE(collection == std::vector<std::string_view>{"one", "three"});
+}
+
+TEST_CASE("Owning parsers compose without copying their flags", "[view]") {
+  const std::vector<std::string> args{"-ab", "one", "--gamma=two", "three"};
+  using Parser = args2::parser::Parser<char, decltype(args.begin())>;
+
+  const Parser parser(args, {'a', 'b'}, {}, {}, {"gamma"});
+  const auto is_flag = [](const auto &result) {
+    const auto token = std::get_if<args2::parser::Token<char>>(&result);
+    return token &&
+           !std::holds_alternative<args2::parser::Positional<char>>(*token);
+  };
+
+  auto flags = parser | std::views::filter(is_flag);
+  static_assert(std::same_as<decltype(flags.base()),
+                             std::ranges::ref_view<const Parser>>);
+  REQUIRE(&flags.base().base() == &parser);
+  REQUIRE(std::ranges::distance(flags) == 3);
+
+  auto owned = Parser(args, {'a', 'b'}, {}, {}, {"gamma"}) |
+               std::views::filter(is_flag);
+  using IsFlag = std::remove_const_t<decltype(is_flag)>;
+  using Owned =
+      std::ranges::filter_view<std::ranges::owning_view<Parser>, IsFlag>;
+  static_assert(std::same_as<decltype(owned), Owned>);
+  REQUIRE(std::ranges::distance(owned) == 3);
+}
+
+TEST_CASE("Parser can pack all results in one pass", "[packed]") {
+  const std::vector<std::string> args{
+      "-acepsilon", "--alpha", "zeta", "--gamma=eta", "--gamma=", "-d",
+      "-btheta",    "--delta", "-abc", "-",           "--",       "-a",
+      "--alpha"};
+  using Parser = args2::parser::Parser<char, decltype(args.begin())>;
+
+  static_assert(sizeof(args2::parser::PackedResult<char>) <
+                sizeof(args2::parser::Result<char>) / 2);
+
+  for (auto end = args.begin(); end != args.end(); ++end) {
+    for (const auto &flags : std::vector<args2::parser::SetFlags<char>>{
+             {{'a', 'b'}, {'c', 'd'}, {"alpha", "beta"}, {"gamma", "delta"}},
+             {{'a'}, {'c', 'd'}, {"beta"}, {"gamma", "delta", "alpha"}},
+             {{'a', 'b', 'c'}, {}, {"gamma"}, {"alpha"}},
+         }) {
+      Parser parser(args.begin(), end + 1, flags);
+
+      std::vector<args2::parser::Result<char>> expected;
+      std::ranges::copy(parser, std::back_inserter(expected));
+
+      std::vector<args2::parser::PackedResult<char>> packed;
+      parser.parse_all(std::back_inserter(packed));
+
+      std::vector<args2::parser::Result<char>> unpacked;
+      for (const auto &result : packed) {
+        unpacked.push_back(result.unpack(args));
+      }
+      REQUIRE(unpacked == expected);
+    }
+  }
+}
+
+TEST_CASE("Parser packs forward-only arguments", "[packed]") {
+  using namespace std::literals::string_view_literals;
+  const args2::split::Nul<char> args(
+      "-acepsilon\0--alpha\0zeta\0--gamma\0eta\0-d\0--\0-a\0"sv);
+  static_assert(!std::ranges::random_access_range<decltype(args)>);
+  using Parser = args2::parser::Parser<char, decltype(args.begin())>;
+  const Parser parser(args, {'a', 'b'}, {'c', 'd'}, {"alpha"}, {"gamma"});
+
+  std::vector<args2::parser::Result<char>> expected;
+  std::ranges::copy(parser, std::back_inserter(expected));
+
+  std::vector<args2::parser::PackedResult<char>> packed;
+  parser.parse_all(std::back_inserter(packed));
+
+  // Walk the arguments alongside the results, which are in argument order.
+  std::vector<args2::parser::Result<char>> unpacked;
+  auto argument = args.begin();
+  std::uint32_t index = 0;
+  for (const auto &result : packed) {
+    for (; index < result.index; ++index) {
+      ++argument;
+    }
+    unpacked.push_back(result.unpack(argument));
+  }
+  REQUIRE(expected.size() == 7);
+  REQUIRE(unpacked == expected);
+}
+
+TEST_CASE("Parser matches abbreviated long flags", "[abbreviations]") {
+  const args2::parser::FlagTable<char> table(
+      {'v'}, {}, {"verbose", "version", "color"}, {"columns", "output"},
+      args2::parser::LongMatching::abbreviations);
+
+  const std::vector<std::string> args{"--verb",   "--colu=80", "--out",
+                                      "file",     "--vers",    "-v",
+                                      "--color=", "--ver"};
+  const auto collect = [&](const auto end) {
+    args2::parser::Parser parser(std::ranges::subrange(args.begin(), end),
+                                 table);
+    std::vector<args2::parser::Result<char>> collection;
+    std::ranges::copy(parser, std::back_inserter(collection));
+
+    std::vector<args2::parser::PackedResult<char>> packed;
+    parser.parse_all(std::back_inserter(packed));
+    std::vector<args2::parser::Result<char>> unpacked;
+    for (const auto &result : packed) {
+      unpacked.push_back(result.unpack(args, table));
+    }
+    REQUIRE(unpacked == collection);
+    return collection;
+  };
+
+  REQUIRE(collect(args.begin() + 6) ==
+          std::vector<args2::parser::Result<char>>{
+              args2::parser::LongFlag<char>("verbose"),
+              args2::parser::LongValueFlag<char>("columns", "80"),
+              args2::parser::LongValueFlag<char>("output", "file"),
+              args2::parser::LongFlag<char>("version"),
+              args2::parser::ShortFlag<char>('v'),
+          });
+
+  const std::vector<std::string_view> candidates{"verbose", "version"};
+  REQUIRE(collect(args.end()) ==
+          std::vector<args2::parser::Result<char>>{
+              args2::parser::LongFlag<char>("verbose"),
+              args2::parser::LongValueFlag<char>("columns", "80"),
+              args2::parser::LongValueFlag<char>("output", "file"),
+              args2::parser::LongFlag<char>("version"),
+              args2::parser::ShortFlag<char>('v'),
+              args2::parser::UnexpectedValueError<char>(
+                  args2::parser::LongValueFlag<char>("color", "")),
+          });
+
+  const std::vector<std::string> ambiguous{"--verbose", "--ver", "--col=1"};
+  std::vector<args2::parser::Result<char>> collection;
+  std::ranges::copy(args2::parser::Parser(ambiguous, table),
+                    std::back_inserter(collection));
+  REQUIRE(collection ==
+          std::vector<args2::parser::Result<char>>{
+              args2::parser::LongFlag<char>("verbose"),
+              args2::parser::AmbiguousFlagError<char>{
+                  args2::parser::LongFlag<char>("ver"), candidates},
+          });
+}
+
+TEST_CASE("Parser can be reset for each command line", "[reuse]") {
+  const args2::parser::FlagTable<char> table({'v'}, {'n'}, {"verbose"},
+                                             {"name"});
+  args2::split::Tokenizer<char> tokenizer(8);
+  args2::parser::Parser<char, args2::split::Tokenizer<char>::iterator,
+                        args2::parser::FlagsRef<args2::parser::FlagTable<char>>>
+      parser(table);
+  REQUIRE(parser.empty());
+
+  std::string buffer;
+  std::vector<args2::parser::Result<char>> collection;
+  collection.reserve(8);
+  const auto parse = [&](const std::string_view line) {
+    buffer = line;
+    collection.clear();
+    std::ranges::copy(parser.parse(tokenizer.split(buffer)),
+                      std::back_inserter(collection));
+    return collection;
+  };
+
+  REQUIRE(parse("add -vn 'first one' --name=second") ==
+          std::vector<args2::parser::Result<char>>{
+              args2::parser::Positional<char>("add"),
+              args2::parser::ShortFlag<char>('v'),
+              args2::parser::ShortValueFlag<char>('n', "first one"),
+              args2::parser::LongValueFlag<char>("name", "second"),
+          });
+  REQUIRE(parse("remove --verbose -- -v") ==
+          std::vector<args2::parser::Result<char>>{
+              args2::parser::Positional<char>("remove"),
+              args2::parser::LongFlag<char>("verbose"),
+              args2::parser::Positional<char>("-v"),
+          });
+  REQUIRE(parse("").empty());
+
+  args2::parser::Parser<char, std::vector<std::string>::const_iterator>
+      set_parser({{'a'}, {}, {}, {}});
+  const std::vector<std::string> args{"-a", "b"};
+  set_parser.reset(args.begin(), args.end());
+  REQUIRE(std::ranges::distance(set_parser) == 2);
+  set_parser.reset(args.begin() + 1, args.end());
+  REQUIRE(std::ranges::distance(set_parser) == 1);
+}
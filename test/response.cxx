@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <args2/argv.hxx>
+#include <args2/parser.hxx>
+#include <args2/response.hxx>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace {
+/** A response file that removes itself.
+ */
+struct TemporaryFile {
+  std::filesystem::path path;
+
+  TemporaryFile(const std::string_view name, const std::string_view contents)
+      : path(std::filesystem::temp_directory_path() / name) {
+    std::ofstream(path, std::ios::binary)
+        .write(contents.data(), contents.size());
+  }
+
+  ~TemporaryFile() { std::filesystem::remove(path); }
+};
+} // namespace
+
+using namespace std::literals::string_view_literals;
+
+TEST_CASE("File maps NUL-separated arguments", "[response]") {
+  const TemporaryFile file("args2-nul.rsp", "--alpha\0one\0-b\0"sv);
+
+  std::error_code error;
+  const args2::response::File<char, args2::response::Format::nul> arguments(
+      file.path, error);
+  REQUIRE(!error);
+
+  std::vector<std::string_view> collection;
+  std::ranges::copy(arguments, std::back_inserter(collection));
+  REQUIRE(collection == std::vector<std::string_view>{"--alpha", "one", "-b"});
+}
+
+TEST_CASE("File reports missing files", "[response]") {
+  std::error_code error;
+  const args2::response::File<char, args2::response::Format::shell> arguments(
+      std::filesystem::temp_directory_path() / "args2-missing.rsp", error);
+  REQUIRE(error == std::errc::no_such_file_or_directory);
+  REQUIRE(arguments.begin() == arguments.end());
+}
+
+TEST_CASE("Expand inlines response files in argv", "[response]") {
+  const TemporaryFile file("args2-shell.rsp",
+                           "--gamma 'two words'\n-d \"three\"\n");
+  const TemporaryFile empty("args2-empty.rsp", "");
+  const auto response = "@" + file.path.string();
+  const auto empty_response = "@" + empty.path.string();
+
+  const char *argv[] = {"-a",
+                        response.c_str(),
+                        "@",
+                        empty_response.c_str(),
+                        "@args2-missing.rsp",
+                        "--",
+                        response.c_str(),
+                        nullptr};
+  const args2::argv::Argv<char> args(7, argv);
+
+  args2::response::Expand<char, args2::argv::Iterator<char>,
+                          args2::response::Format::shell>
+      expanded(args);
+
+  std::vector<std::string_view> collection;
+  std::ranges::copy(expanded.begin(), expanded.end(),
+                    std::back_inserter(collection));
+  REQUIRE(collection ==
+          std::vector<std::string_view>{
+              "-a", "--gamma", "two words", "-d", "three", "@",
+              "@args2-missing.rsp", "--", "--gamma", "two words", "-d",
+              "three"});
+  REQUIRE(expanded.error() == std::errc::no_such_file_or_directory);
+
+  using Parser = args2::parser::Parser<char, decltype(expanded.begin())>;
+  Parser parser(expanded.begin(), expanded.end(),
+                {{'a'}, {'d'}, {}, {"gamma"}});
+
+  std::vector<args2::parser::Result<char>> results;
+  std::ranges::copy(parser, std::back_inserter(results));
+  REQUIRE(results.size() == 9);
+  REQUIRE(results[1] == args2::parser::Result<char>(
+                            args2::parser::LongValueFlag<char>("gamma",
+                                                               "two words")));
+  REQUIRE(results[2] == args2::parser::Result<char>(
+                            args2::parser::ShortValueFlag<char>('d', "three")));
+}
+
+TEST_CASE("Shell response files can be iterated again", "[response]") {
+  const TemporaryFile file("args2-again.rsp", "-a 'two words' \"x y\" -b\n");
+  const auto response = "@" + file.path.string();
+
+  const char *argv[] = {response.c_str(), "c", nullptr};
+  const args2::argv::Argv<char> args(2, argv);
+
+  const args2::response::Expand<char, args2::argv::Iterator<char>,
+                                args2::response::Format::shell>
+      expanded(args);
+  static_assert(std::ranges::forward_range<decltype(expanded)>);
+
+  using Parser = args2::parser::Parser<char, decltype(expanded.begin())>;
+  const Parser parser(expanded, {{'a', 'b'}, {}, {}, {}});
+
+  using args2::parser::Positional;
+  using args2::parser::Result;
+  using args2::parser::ShortFlag;
+  const std::vector<Result<char>> expected{
+      ShortFlag<char>{'a'}, Positional<char>{"two words"},
+      Positional<char>{"x y"}, ShortFlag<char>{'b'}, Positional<char>{"c"}};
+  for (int pass = 0; pass < 2; ++pass) {
+    std::vector<Result<char>> results;
+    std::ranges::copy(parser, std::back_inserter(results));
+    REQUIRE(results == expected);
+  }
+  REQUIRE(!expanded.error());
+
+  std::error_code error;
+  const args2::response::File<char, args2::response::Format::shell> arguments(
+      file.path, error);
+  REQUIRE(!error);
+  for (int pass = 0; pass < 2; ++pass) {
+    REQUIRE(std::ranges::equal(arguments,
+                               std::vector<std::string_view>{
+                                   "-a", "two words", "x y", "-b"}));
+  }
+}
@@ -0,0 +1,77 @@
+#include <args2/split.hxx>
+#include <catch2/catch_test_macros.hpp>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals::string_view_literals;
+
+TEST_CASE("Nul splits on NUL characters", "[split]") {
+  const auto buffer = "alpha\0--beta\0\0gamma delta\0"sv;
+
+  std::vector<std::string_view> collection;
+  std::ranges::copy(args2::split::Nul<char>(buffer),
+                    std::back_inserter(collection));
+  REQUIRE(collection ==
+          std::vector<std::string_view>{"alpha", "--beta", "", "gamma delta"});
+
+  collection.clear();
+  std::ranges::copy(args2::split::Nul<char>("alpha\0beta"sv),
+                    std::back_inserter(collection));
+  REQUIRE(collection == std::vector<std::string_view>{"alpha", "beta"});
+
+  REQUIRE(args2::split::Nul<char>(""sv).begin() ==
+          args2::split::Nul<char>(""sv).end());
+}
+
+TEST_CASE("Shell splits and unquotes in place", "[split]") {
+  std::string buffer = "  alpha\t'beta gamma'\n\"delta \\\"epsilon\\\" \\q\"  "
+                       "zeta\\ eta 'it'\\''s' \"\" line\\\ncontinued";
+  const auto original_begin = buffer.data();
+  const auto original_end = buffer.data() + buffer.size();
+
+  std::vector<std::string_view> collection;
+  std::ranges::copy(args2::split::Shell<char>(buffer),
+                    std::back_inserter(collection));
+  REQUIRE(collection == std::vector<std::string_view>{
+                            "alpha", "beta gamma", "delta \"epsilon\" \\q",
+                            "zeta eta", "it's", "", "linecontinued"});
+  for (const auto arg : collection) {
+    REQUIRE(arg.data() >= original_begin);
+    REQUIRE(arg.data() + arg.size() <= original_end);
+  }
+}
+
+TEST_CASE("Shell leaves unquoted text untouched", "[split]") {
+  const std::string original = "--alpha=one -bc two";
+  std::string buffer = original;
+
+  std::vector<std::string_view> collection;
+  std::ranges::copy(args2::split::Shell<char>(buffer),
+                    std::back_inserter(collection));
+  REQUIRE(collection ==
+          std::vector<std::string_view>{"--alpha=one", "-bc", "two"});
+  REQUIRE(buffer == original);
+}
+
+TEST_CASE("Tokenizer reuses its storage", "[split]") {
+  args2::split::Tokenizer<char> tokenizer;
+
+  std::string first = "set --name 'a b' -v";
+  const auto args = tokenizer.split(first);
+  REQUIRE(std::ranges::equal(
+      args, std::vector<std::string_view>{"set", "--name", "a b", "-v"}));
+  REQUIRE(args.front().data() == first.data());
+
+  std::string second = "get \"x\\\"y\"\n";
+  const auto again = tokenizer.split(second);
+  REQUIRE(std::ranges::equal(again,
+                             std::vector<std::string_view>{"get", "x\"y"}));
+  REQUIRE(again.data() == args.data());
+  REQUIRE(std::ranges::equal(tokenizer.get(), again));
+
+  std::string blank = " \t\n";
+  REQUIRE(tokenizer.split(blank).empty());
+}